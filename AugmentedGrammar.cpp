@@ -1,7 +1,7 @@
 // AugmentedGrammar.cpp
 #include "AugmentedGrammar.h"
 
-AugmentedGrammar::AugmentedGrammar(std::map<std::string, std::vector<std::vector<std::string>>> prod)
+AugmentedGrammar::AugmentedGrammar(const std::map<std::string, std::vector<std::vector<std::string>>>& prod)
     : productions(prod) {
     if (!productions.empty()) {
         originalStart = "S" ; //productions.begin()->first;
@@ -13,6 +13,6 @@ void AugmentedGrammar::addAugmentedRule() {
     productions["S'"] = { rhs };
 }
 
-std::map<std::string, std::vector<std::vector<std::string>>> AugmentedGrammar::getAugmentedProductions() {
+const std::map<std::string, std::vector<std::vector<std::string>>>& AugmentedGrammar::getAugmentedProductions() const {
     return productions;
 }
\ No newline at end of file
@@ -6,9 +6,9 @@
 
 class AugmentedGrammar {
 public:
-    AugmentedGrammar(std::map<std::string, std::vector<std::vector<std::string>>> prod);
+    explicit AugmentedGrammar(const std::map<std::string, std::vector<std::vector<std::string>>>& prod);
     void addAugmentedRule();
-    std::map<std::string, std::vector<std::vector<std::string>>> getAugmentedProductions();
+    const std::map<std::string, std::vector<std::vector<std::string>>>& getAugmentedProductions() const;
     std::string originalStart;
 private:
     std::map<std::string, std::vector<std::vector<std::string>>> productions;
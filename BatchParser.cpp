@@ -0,0 +1,87 @@
+// BatchParser.cpp
+#include "BatchParser.h"
+#include "TokenBuffer.h"
+#include <chrono>
+#include <istream>
+#include <ostream>
+#include <utility>
+
+BatchParser::BatchParser(SharedParseTables tables)
+    : tables(std::move(tables)) {}
+
+ParseTable::Result BatchParser::parseLine(std::string_view line) {
+    tokens.clear();
+    tokenText.clear();
+
+    TokenBuffer::split(line, tokenText);
+    for (std::string_view token : tokenText) {
+        tokens.push_back(tables->terminal(token));
+    }
+
+    if (!buildTrees) {
+        return tables->parse(tokens, stack);
+    }
+    return tables->parse(tokens, stack, tree);
+}
+
+void BatchParser::setSyntaxTrees(bool enabled, SyntaxTree::Mode mode) {
+    buildTrees = enabled;
+    tree.setMode(mode);
+    tree.clear();
+}
+
+void BatchParser::parseOne(std::string_view line, Report& report, std::ostream* results) {
+    ParseTable::Result result = parseLine(line);
+    report.sequences++;
+    report.tokens += tokens.size();
+
+    if (result.accepted) {
+        report.accepted++;
+    } else {
+        report.rejected++;
+    }
+
+    if (results) {
+        *results << report.sequences << ": ";
+        if (result.accepted && buildTrees) {
+            *results << "accept ";
+            tree.write(*results, tables->symbols());
+        } else if (result.accepted) {
+            *results << "accept\n";
+        } else {
+            *results << "reject at token " << result.errorPosition << " ('"
+                     << (result.errorPosition < tokenText.size() ? tokenText[result.errorPosition]
+                                                                 : std::string_view("$"))
+                     << "')\n";
+        }
+    }
+}
+
+BatchParser::Report BatchParser::parseStream(std::istream& in, std::ostream* results) {
+    Report report;
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::string line;
+    while (std::getline(in, line)) {
+        parseOne(line, report, results);
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return report;
+}
+
+BatchParser::Report BatchParser::parseBuffer(std::string_view buffer, std::ostream* results) {
+    Report report;
+    auto startTime = std::chrono::steady_clock::now();
+
+    size_t pos = 0;
+    while (pos < buffer.size()) {
+        size_t end = buffer.find('\n', pos);
+        if (end == std::string_view::npos) end = buffer.size();
+        parseOne(buffer.substr(pos, end - pos), report, results);
+        pos = end + 1;
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return report;
+}
@@ -0,0 +1,52 @@
+// BatchParser.h
+#pragma once
+#include "ParseTables.h"
+#include "SyntaxTree.h"
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Non-interactive parse engine: runs the compiled tables over a stream of
+// token sequences, one whitespace-separated sequence per line, with no
+// per-step I/O or state copies. An instance only owns its scratch stacks, so
+// use one per thread; all instances may share the same tables.
+class BatchParser {
+public:
+    struct Report {
+        size_t sequences = 0;
+        size_t accepted = 0;
+        size_t rejected = 0;
+        size_t tokens = 0;
+        double seconds = 0.0;
+
+        double tokensPerSecond() const { return seconds > 0 ? tokens / seconds : 0.0; }
+    };
+
+    explicit BatchParser(SharedParseTables tables);
+
+    // Parses one sequence; on rejection errorPosition is the index of the
+    // failing token (the token count for the end marker)
+    ParseTable::Result parseLine(std::string_view line);
+
+    // Parse every line; when `results` is given, one accept/reject line
+    // (with the failing position and token) is written per sequence
+    Report parseStream(std::istream& in, std::ostream* results = nullptr);
+    Report parseBuffer(std::string_view buffer, std::ostream* results = nullptr);
+
+    // Builds a parse tree for every sequence (off by default); accepted
+    // sequences then have their tree appended to the result line
+    void setSyntaxTrees(bool enabled, SyntaxTree::Mode mode = SyntaxTree::Concrete);
+    const SyntaxTree& getTree() const { return tree; }   // of the last sequence
+
+private:
+    SharedParseTables tables;
+    std::vector<int> tokens;   // reused across sequences
+    std::vector<int> stack;    // reused across sequences
+    std::vector<std::string_view> tokenText;
+    SyntaxTree tree;           // reused across sequences
+    bool buildTrees = false;
+
+    void parseOne(std::string_view line, Report& report, std::ostream* results);
+};
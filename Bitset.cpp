@@ -0,0 +1,64 @@
+// Bitset.cpp
+#include "Bitset.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+Bitset::Bitset(size_t bits)
+    : words((bits + 63) / 64, 0), bits(bits) {}
+
+bool Bitset::unite(const Bitset& other) {
+    return unite(other.words.data());
+}
+
+bool Bitset::unite(const uint64_t* src) {
+    uint64_t* dst = words.data();
+    size_t n = words.size();
+    size_t i = 0;
+    uint64_t added = 0;
+
+#if defined(__SSE2__)
+    __m128i addedVec = _mm_setzero_si128();
+    for (; i + 2 <= n; i += 2) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        addedVec = _mm_or_si128(addedVec, _mm_andnot_si128(a, b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(a, b));
+    }
+    added = static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(addedVec, _mm_setzero_si128())) != 0xFFFF);
+#endif
+    for (; i < n; ++i) {
+        added |= src[i] & ~dst[i];
+        dst[i] |= src[i];
+    }
+    return added != 0;
+}
+
+bool Bitset::intersects(const Bitset& other) const {
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (words[i] & other.words[i]) return true;
+    }
+    return false;
+}
+
+void Bitset::clear() {
+    for (auto& word : words) word = 0;
+}
+
+size_t Bitset::count() const {
+    size_t total = 0;
+    for (auto word : words) {
+        while (word) {
+            word &= word - 1;
+            total++;
+        }
+    }
+    return total;
+}
+
+bool Bitset::empty() const {
+    for (auto word : words) {
+        if (word) return false;
+    }
+    return true;
+}
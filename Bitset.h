@@ -0,0 +1,56 @@
+// Bitset.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+inline int lowestSetBit(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// Fixed-size set of small integers (terminal IDs) stored as 64-bit words.
+// unite() works a whole word, or a SIMD register, at a time.
+class Bitset {
+public:
+    Bitset() = default;
+    explicit Bitset(size_t bits);
+
+    void set(size_t bit) { words[bit >> 6] |= uint64_t(1) << (bit & 63); }
+    bool test(size_t bit) const { return (words[bit >> 6] >> (bit & 63)) & 1; }
+    size_t size() const { return bits; }
+
+    bool unite(const Bitset& other);  // returns true if any bit was added
+    bool unite(const uint64_t* other);  // the same from raw words, as many as data() has
+    bool intersects(const Bitset& other) const;
+    void clear();
+    size_t count() const;
+    bool empty() const;
+    bool operator==(const Bitset& other) const { return words == other.words; }
+    bool operator!=(const Bitset& other) const { return words != other.words; }
+    const uint64_t* data() const { return words.data(); }
+
+    // Calls f(bit) for every set bit in ascending order
+    template <typename F>
+    void forEach(F f) const {
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t word = words[w];
+            while (word) {
+                f(w * 64 + static_cast<size_t>(lowestSetBit(word)));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    std::vector<uint64_t> words;
+    size_t bits = 0;
+};
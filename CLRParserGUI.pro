@@ -6,16 +6,54 @@ SOURCES += \
     mainwindow.cpp \
     GrammarInput.cpp \
     AugmentedGrammar.cpp \
+    Grammar.cpp \
+    Bitset.cpp \
     FirstFollow.cpp \
+    GrammarDiff.cpp \
+    MemoryStats.cpp \
+    ItemSet.cpp \
     ItemSetGenerator.cpp \
-    CanonicalLRParser.cpp
+    ThreadPool.cpp \
+    SymbolTable.cpp \
+    ParseTable.cpp \
+    CompressedParseTable.cpp \
+    ParseTables.cpp \
+    TableFile.cpp \
+    TableCache.cpp \
+    SimulationTrace.cpp \
+    TokenBuffer.cpp \
+    SyntaxTree.cpp \
+    CodeGenerator.cpp \
+    LazyAutomaton.cpp \
+    CanonicalLRParser.cpp \
+    BatchParser.cpp
 
 HEADERS += \
     mainwindow.h \
     GrammarInput.h \
     AugmentedGrammar.h \
+    Grammar.h \
+    Bitset.h \
     FirstFollow.h \
+    GrammarDiff.h \
+    MemoryStats.h \
+    ItemSet.h \
     ItemSetGenerator.h \
-    CanonicalLRParser.h
+    ThreadPool.h \
+    SymbolTable.h \
+    ParseTable.h \
+    CompressedParseTable.h \
+    ParseTables.h \
+    TableFile.h \
+    TableCache.h \
+    LRDriver.h \
+    SemanticActions.h \
+    SimulationTrace.h \
+    TokenBuffer.h \
+    SyntaxTree.h \
+    CodeGenerator.h \
+    LazyAutomaton.h \
+    CanonicalLRParser.h \
+    BatchParser.h
 
 # No FORMS section since we're not using .ui files
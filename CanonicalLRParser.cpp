@@ -1,5 +1,6 @@
 //CanonicalLRParser.cpp
 #include "CanonicalLRParser.h"
+#include "CodeGenerator.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -7,13 +8,13 @@
 #include <iomanip>
 
 CanonicalLRParser::CanonicalLRParser()
-    : augmentedGrammar(nullptr), firstFollow(nullptr), itemSetGenerator(nullptr) {}
+    : grammarFile("grammar.txt"), inputPath("input.txt"),
+      compressTables(false), constructionMode(ConstructionMode::CanonicalLR1), threadCount(1),
+      tableCache(nullptr), tablesFromCache(false), incremental(true),
+      lazyConstruction(false), lazyTables(false),
+      inputFromFile(true), currentSimulationStep(0) {}
 
-CanonicalLRParser::~CanonicalLRParser() {
-    delete augmentedGrammar;
-    delete firstFollow;
-    delete itemSetGenerator;
-}
+CanonicalLRParser::~CanonicalLRParser() = default;
 
 // Add this new method implementation (before run()):
 std::string CanonicalLRParser::getOutput() const {
@@ -25,35 +26,136 @@ void CanonicalLRParser::clearOutput() {
 }
 
 
+void CanonicalLRParser::setConstructionMode(ConstructionMode mode) {
+    constructionMode = mode;
+}
+
+void CanonicalLRParser::setThreadCount(unsigned threads) {
+    threadCount = threads;
+}
+
+void CanonicalLRParser::setGrammarFile(const std::string& path) {
+    grammarFile = path;
+}
+
+void CanonicalLRParser::setInputFile(const std::string& path) {
+    inputPath = path;
+    inputFromFile = true;
+}
+
+void CanonicalLRParser::setInput(std::string text) {
+    simulationInput.assign(std::move(text));
+    inputFromFile = false;
+}
+
+void CanonicalLRParser::setTableCache(TableCache* cache) {
+    tableCache = cache;
+}
+
+void CanonicalLRParser::setIncremental(bool enabled) {
+    incremental = enabled;
+}
+
+void CanonicalLRParser::setLazyConstruction(bool enabled) {
+    lazyConstruction = enabled;
+}
+
 // Modify the run() method to use outputStream instead of cout:
 void CanonicalLRParser::run() {
     outputStream.str(""); // Clear the stream
 
     // Step 1: Read and display grammar
-    grammarInput.readGrammar();
+    if (!grammarInput.readGrammar(grammarFile)) {
+        throw std::runtime_error("Could not open grammar file '" + grammarFile + "'");
+    }
     outputStream << "=== Grammar ===\n";
     grammarInput.displayGrammar(outputStream);
 
-    // Step 2: Create augmented grammar
-    augmentedGrammar = new AugmentedGrammar(grammarInput.getProductions());
-    augmentedGrammar->addAugmentedRule();
+    // Step 2: Create augmented grammar, interned once for all later steps
+    AugmentedGrammar augmentedGrammar(grammarInput.getProductions());
+    augmentedGrammar.addAugmentedRule();
+    grammar = std::make_shared<const Grammar>(augmentedGrammar.getAugmentedProductions());
+
+    // Tables cached for this exact grammar and mode skip steps 3 and 4
+    tables.reset();
+    tablesFromCache = false;
+    lazyTables = false;
+    if (tableCache) {
+        cacheKey = TableCache::key(grammar->symbols(), grammar->productions(), constructionMode);
+        tables = tableCache->find(cacheKey, compressTables);
+        if (tables) {
+            tablesFromCache = true;
+            outputStream << "\nParse tables loaded from cache; FIRST/FOLLOW sets and item sets "
+                         << "were not rebuilt\n";
+            return;
+        }
+    }
+
+    // The previous build, if any, is the base for an incremental one
+    std::unique_ptr<FirstFollow> previousFirstFollow = std::move(firstFollow);
+    std::unique_ptr<ItemSetGenerator> previousItemSets = std::move(itemSetGenerator);
+    std::unique_ptr<GrammarDiff> diff;
+    if (incremental && previousItemSets) {
+        diff = std::make_unique<GrammarDiff>(*previousItemSets->getGrammar(), *grammar);
+    }
 
     // Step 3: Compute FIRST and FOLLOW sets
-    firstFollow = new FirstFollow(augmentedGrammar->getAugmentedProductions());
-    firstFollow->computeFirst();
-    firstFollow->computeFollow("S'");
+    firstFollow = std::make_unique<FirstFollow>(grammar);
+    if (diff) {
+        firstFollow->computeIncremental(*previousFirstFollow, *diff, "S'");
+    } else {
+        firstFollow->computeFirst();
+        firstFollow->computeFollow("S'");
+    }
     outputStream << "\n=== First and Follow Sets ===\n";
     firstFollow->displayFirstFollow(outputStream);
 
     // Step 4: Generate item sets
-    itemSetGenerator = new ItemSetGenerator(
-        augmentedGrammar->getAugmentedProductions(),
-        firstFollow->getFirst()
+    itemSetGenerator = std::make_unique<ItemSetGenerator>(
+        grammar,
+        firstFollow->getFirst(),
+        firstFollow->getNullable()
         );
+    itemSetGenerator->setConstructionMode(constructionMode);
+    itemSetGenerator->setThreadCount(threadCount);
+    if (lazyConstruction && constructionMode == ConstructionMode::CanonicalLR1) {
+        // Merging modes depend on the order states are found, so only
+        // canonical construction can be left to the parser
+        lazyTables = true;
+        outputStream << "\n=== Item Sets ===\nBuilt on demand while parsing (lazy construction)\n";
+        return;
+    }
+    if (lazyConstruction) {
+        outputStream << "\nLazy construction applies to canonical LR(1) only; building all item sets\n";
+    }
+    if (diff) {
+        itemSetGenerator->reuseClosures(*previousItemSets, *diff);
+    }
     itemSetGenerator->generateItemSets();
     outputStream << "\n=== Item Sets ===\n";
     itemSetGenerator->displayItemSets(outputStream);
 
+    const ItemSetStats& stats = itemSetGenerator->getStats();
+    outputStream << constructionModeName(constructionMode)
+                 << " states: " << stats.states
+                 << ", transitions: " << stats.transitions
+                 << ", closures: " << stats.closures
+                 << ", kernel lookups: " << stats.kernelLookups
+                 << " (" << stats.kernelHits << " hits)"
+                 << ", merges: " << stats.merges
+                 << ", reused closures: " << stats.reusedClosures
+                 << ", threads: " << stats.threads
+                 << ", built in " << std::fixed << std::setprecision(2)
+                 << stats.milliseconds << " ms\n";
+    outputStream << "Item set memory: " << stats.bytes / 1024 << " KB stored, "
+                 << stats.scratchBytes / 1024 << " KB scratch (grew during "
+                 << stats.scratchGrowingCalls << " closure/GOTO calls, not counting "
+                 << "allocations per call), peak RSS "
+                 << stats.peakRssKb << " KB\n";
+    if (diff) {
+        outputStream << "Incremental build: " << diff->changedCount() << " non-terminal(s) changed\n";
+    }
+
     // Step 5: Generate parse tables
     //generateParseTable();
 
@@ -62,75 +164,172 @@ void CanonicalLRParser::run() {
     //simulateParser();
 }
 void CanonicalLRParser::generateParseTable() {
+    if (lazyTables) {
+        tables = ParseTables::lazy(*itemSetGenerator);
+        outputStream << "\nParse tables are built lazily: states are added as parsing reaches them\n";
+        return;
+    }
+    if (!tablesFromCache) {
+        buildParseTable();
+        if (tableCache) {
+            tableCache->store(cacheKey, *tables);
+        }
+    }
+    const ParseTableView& parseTable = tables->table();
+    const SymbolTable& symbols = grammar->symbols();
+    const int terminalCount = symbols.terminalCount();
+
+    // Display ACTION table
+    outputStream << "\nACTION Table:\n";
+    for (int state = 0; state < parseTable.stateCount(); ++state) {
+        std::ostringstream row;
+        for (int terminal = 0; terminal < terminalCount; ++terminal) {
+            ParseTable::Action action = parseTable.action(state, terminal);
+            if (ParseTable::kind(action) != ParseTable::Error) {
+                row << symbols.name(terminal) << "=" << ParseTable::describe(action) << " ";
+            }
+        }
+        if (!row.str().empty()) {
+            outputStream << "State " << state << ": " << row.str() << "\n";
+        }
+    }
+
+    // Display GOTO table
+    outputStream << "\nGOTO Table:\n";
+    for (int state = 0; state < parseTable.stateCount(); ++state) {
+        std::ostringstream row;
+        for (int nonTerminal = 0; nonTerminal < parseTable.nonTerminalCount(); ++nonTerminal) {
+            int target = parseTable.gotoState(state, nonTerminal);
+            if (target >= 0) {
+                row << symbols.name(terminalCount + nonTerminal) << "=" << target << " ";
+            }
+        }
+        if (!row.str().empty()) {
+            outputStream << "State " << state << ": " << row.str() << "\n";
+        }
+    }
+
+    if (tables->conflictCount() > 0) {
+        outputStream << "\n" << tables->conflictCount() << " conflict(s) resolved "
+                     << "(shift preferred over reduce, then the lower-numbered rule)\n";
+    }
+
+    if (compressTables) {
+        outputStream << "\nTable size: " << getRawTableBytes() << " bytes raw, "
+                     << getCompressedTableBytes() << " bytes compressed\n";
+    }
+    if (tableCache) {
+        const TableCache::Stats& cacheStats = tableCache->getStats();
+        outputStream << "\nTable cache: " << cacheStats.hits << " hits, " << cacheStats.misses
+                     << " misses, " << cacheStats.evictions << " evictions, "
+                     << tableCache->totalBytes() << " bytes on disk\n";
+    }
+}
+
+void CanonicalLRParser::buildParseTable() {
     const auto& itemSets = itemSetGenerator->getItemSets();
     const auto& transitions = itemSetGenerator->getTransitions();
-    const auto& productions = augmentedGrammar->getAugmentedProductions();
-    const auto& follow = firstFollow->getFollow();
-
-    // Create production index mapping
-    std::map<std::pair<std::string, std::vector<std::string>>, int> productionIndex;
-    int productionNumber = 0;
-    for (const auto& production : productions) {
-        const std::string& lhs = production.first;
-        for (const auto& rhs : production.second) {
-            productionIndex[{lhs, rhs}] = productionNumber++;
-        }
+    const SymbolTable& symbols = grammar->symbols();
+    const std::vector<Production>& productions = grammar->productions();
+    const int augmentedStart = grammar->augmentedStart();
+    const int terminalCount = symbols.terminalCount();
+
+    ParseTable parseTable(static_cast<int>(itemSets.size()), terminalCount, symbols.nonTerminalCount());
+    for (size_t rule = 0; rule < productions.size(); ++rule) {
+        parseTable.setRule(static_cast<int>(rule), productions[rule].lhs - terminalCount,
+                           static_cast<int>(productions[rule].rhs.size()));
     }
 
-    // Build ACTION and GOTO tables
+    // Build ACTION and GOTO tables; an item's production index is its rule number
+    size_t conflicts = 0;
     for (size_t stateId = 0; stateId < itemSets.size(); ++stateId) {
+        int state = static_cast<int>(stateId);
         for (const auto& item : itemSets[stateId]) {
-            if (item.dot < item.rhs.size()) {
+            const Production& production = productions[item.production];
+            if (item.dot < production.rhs.size()) {
                 // Shift or Goto operation
-                const std::string& symbol = item.rhs[item.dot];
-                auto transitionIter = transitions.find({static_cast<int>(stateId), symbol});
+                int symbol = production.rhs[item.dot];
+                auto transitionIter = transitions.find({state, symbol});
 
                 if (transitionIter != transitions.end()) {
-                    if (productions.find(symbol) != productions.end()) {
+                    if (!symbols.isTerminal(symbol)) {
                         // Non-terminal - GOTO
-                        gotoTable[stateId][symbol] = transitionIter->second;
+                        parseTable.setGoto(state, symbol - terminalCount, transitionIter->second);
                     } else {
                         // Terminal - SHIFT
-                        actionTable[stateId][symbol] = "s" + std::to_string(transitionIter->second);
+                        conflicts += !parseTable.setAction(state, symbol,
+                            ParseTable::makeAction(ParseTable::Shift, transitionIter->second));
                     }
                 }
+            } else if (production.lhs == augmentedStart) {
+                // Accept action
+                conflicts += !parseTable.setAction(state, SymbolTable::endMarker,
+                    ParseTable::makeAction(ParseTable::Accept, 0));
             } else {
-                // Reduce or Accept operation
-                if (item.lhs == "S'" && item.rhs.size() == 1 && item.rhs[0] == augmentedGrammar->originalStart) {
-                    // Accept action
-                    actionTable[stateId]["$"] = "acc";
-                } else {
-                    // Reduce action
-                    auto productionKey = std::make_pair(item.lhs, item.rhs);
-                    int ruleNumber = productionIndex[productionKey];
-
-                    for (const auto& lookahead : follow.at(item.lhs)) {
-                        actionTable[stateId][lookahead] = "r" + std::to_string(ruleNumber);
-                    }
-                }
+                // Reduce action, on each of the item's lookaheads
+                item.forEachLookahead([&](size_t lookahead) {
+                    conflicts += !parseTable.setAction(state, static_cast<int>(lookahead),
+                        ParseTable::makeAction(ParseTable::Reduce, static_cast<int>(item.production)));
+                });
             }
         }
     }
 
-    // Display ACTION table
-    outputStream << "\nACTION Table:\n";
-    for (const auto& stateActions : actionTable) {
-        outputStream << "State " << stateActions.first << ": ";
-        for (const auto& symbolAction : stateActions.second) {
-            outputStream << symbolAction.first << "=" << symbolAction.second << " ";
-        }
-        outputStream << "\n";
+    tables = std::make_shared<const ParseTables>(symbols, std::move(parseTable), compressTables, conflicts, grammar);
+}
+
+void CanonicalLRParser::setTableCompression(bool enabled) {
+    compressTables = enabled;
+}
+
+size_t CanonicalLRParser::getRawTableBytes() const {
+    return tables ? tables->table().byteSize() : 0;
+}
+
+size_t CanonicalLRParser::getCompressedTableBytes() const {
+    return tables && tables->isCompressed() ? tables->compressedTable().byteSize() : 0;
+}
+
+SharedParseTables CanonicalLRParser::getTables() const {
+    return tables;
+}
+
+void CanonicalLRParser::generateHeader(const std::string& path, const std::string& nameSpace) const {
+    if (!tables) {
+        throw std::runtime_error("Parse table has not been generated");
     }
+    CodeGenerator(*tables, nameSpace, grammarFile).writeTableHeader(path);
+}
 
-    // Display GOTO table
-    outputStream << "\nGOTO Table:\n";
-    for (const auto& stateGotos : gotoTable) {
-        outputStream << "State " << stateGotos.first << ": ";
-        for (const auto& symbolTarget : stateGotos.second) {
-            outputStream << symbolTarget.first << "=" << symbolTarget.second << " ";
+int CanonicalLRParser::getRuleNumber(const std::string& lhs, const std::vector<std::string>& rhs) const {
+    if (!grammar) return -1;
+    const SymbolTable& symbols = grammar->symbols();
+    const std::vector<Production>& productions = grammar->productions();
+    for (size_t rule = 0; rule < productions.size(); ++rule) {
+        const Production& production = productions[rule];
+        if (symbols.name(production.lhs) != lhs || production.rhs.size() != rhs.size()) continue;
+        bool same = true;
+        for (size_t i = 0; i < rhs.size() && same; ++i) {
+            same = symbols.name(production.rhs[i]) == rhs[i];
         }
-        outputStream << "\n";
+        if (same) return static_cast<int>(rule);
     }
+    return -1;
+}
+
+ParseTable::Result CanonicalLRParser::parse(const std::vector<std::string>& tokens) const {
+    if (!tables) {
+        throw std::runtime_error("Parse table has not been generated");
+    }
+
+    std::vector<int> ids;
+    ids.reserve(tokens.size());
+    for (const auto& token : tokens) {
+        ids.push_back(tables->terminal(token));
+    }
+
+    std::vector<int> stack;
+    return tables->parse(ids, stack);
 }
 
 /*void CanonicalLRParser::simulateParser() {
@@ -220,38 +419,36 @@ void CanonicalLRParser::generateParseTable() {
 }*/
 /********************************************/
 void CanonicalLRParser::prepareSimulation() {
-    simulationStates.clear();
+    trace = SimulationTrace();
+    simulationTokens.clear();
     currentSimulationStep = 0;
+    if (!tables) {
+        throw std::runtime_error("Parse table has not been generated");
+    }
 
     // Tokenize input
-    std::ifstream inputFile("input.txt");
-    if (!inputFile.is_open()) {
-        throw std::runtime_error("Could not open input.txt file");
+    if (inputFromFile) {
+        std::ifstream inputFile(inputPath);
+        if (!inputFile.is_open()) {
+            throw std::runtime_error("Could not open input file '" + inputPath + "'");
+        }
+        std::string input;
+        std::getline(inputFile, input);
+        simulationInput.assign(std::move(input));
     }
-    std::string input;
-    std::getline(inputFile, input);
-    inputFile.close();
 
-    std::vector<std::string> tokens;
-    std::istringstream iss(input);
-    std::string token;
-    while (iss >> token) {
-        tokens.push_back(token);
+    simulationTokens.reserve(simulationInput.size());
+    for (size_t i = 0; i < simulationInput.size(); ++i) {
+        simulationTokens.push_back(tables->terminal(simulationInput[i]));
     }
 
     // Initialize first state
-    SimulationState initialState;
-    initialState.stateStack.push(0);
-    initialState.inputPointer = 0;
-    initialState.accepted = false;
-    initialState.error = false;
-    simulationStates.push_back(initialState);
+    trace.start();
 }
 
 bool CanonicalLRParser::hasNextStep() const {
-    if (simulationStates.empty()) return false;
-    return currentSimulationStep < simulationStates.size() - 1 ||
-           (!simulationStates.back().accepted && !simulationStates.back().error);
+    if (trace.size() == 0) return false;
+    return currentSimulationStep < trace.size() - 1 || !trace.finished();
 }
 
 bool CanonicalLRParser::hasPreviousStep() const {
@@ -295,7 +492,7 @@ std::string CanonicalLRParser::getCurrentStepOutput() const {
 
     // Display input pointer
     oss << "Remaining input: ";
-    std::ifstream inputFile("input.txt");
+    std::ifstream inputFile(inputPath);
     std::string input;
     if (inputFile.is_open()) {
         std::getline(inputFile, input);
@@ -327,55 +524,37 @@ std::string CanonicalLRParser::getCurrentStepOutput() const {
 }*/
 
 std::string CanonicalLRParser::getCurrentStepOutput() const {
-    if (simulationStates.empty() || currentSimulationStep >= simulationStates.size()) {
+    if (trace.size() == 0 || currentSimulationStep >= trace.size()) {
         return "No simulation data available";
     }
 
-    const SimulationState& state = simulationStates[currentSimulationStep];
+    const SimulationTrace::Step& step = trace.step(currentSimulationStep);
     std::ostringstream oss;
 
     // Display input pointer
     oss << "Remaining input: ";
-    std::ifstream inputFile("input.txt");
-    std::string input;
-    if (inputFile.is_open()) {
-        std::getline(inputFile, input);
-        inputFile.close();
-    }
-    std::istringstream iss(input);
-    std::string token;
-    size_t pos = 0;
-    while (iss >> token) {
-        if (pos >= state.inputPointer) {
-            oss << token << " ";
-        }
-        pos++;
+    for (size_t pos = step.inputPointer; pos < simulationInput.size(); ++pos) {
+        oss << simulationInput[pos] << " ";
     }
     oss << "$\n\n";  // End marker
 
     // Display action
-    if (!state.currentAction.empty()) {
-        oss << "Action: " << state.currentAction << "\n\n";
+    std::string action = ParseTable::describe(step.action);
+    if (!action.empty()) {
+        oss << "Action: " << action << "\n\n";
     }
 
     // Display stack in a visual format
     oss << "STACK:\n";
     oss << "┌─────────────┐\n";
 
-    std::stack<int> stateStackCopy = state.stateStack;
-    std::stack<std::string> symbolStackCopy = state.symbolStack;
-    std::vector<std::pair<int, std::string>> stackContents;
-
-    // Collect stack contents in reverse order (top to bottom)
-    while (!stateStackCopy.empty() && !symbolStackCopy.empty()) {
-        stackContents.emplace_back(stateStackCopy.top(), symbolStackCopy.top());
-        stateStackCopy.pop();
-        symbolStackCopy.pop();
-    }
+    const SymbolTable& symbols = grammar->symbols();
+    std::vector<SimulationTrace::Entry> stackContents;
+    trace.stack(currentSimulationStep, stackContents);
 
     // Print stack from bottom to top
-    for (auto it = stackContents.rbegin(); it != stackContents.rend(); ++it) {
-        oss << "│ " << std::setw(3) << it->first << " │ " << std::setw(6) << it->second << " │\n";
+    for (const auto& entry : stackContents) {
+        oss << "│ " << std::setw(3) << entry.state << " │ " << std::setw(6) << symbols.name(entry.symbol) << " │\n";
         oss << "├─────────────┤\n";
     }
 
@@ -383,9 +562,9 @@ std::string CanonicalLRParser::getCurrentStepOutput() const {
     oss << "│     $     │\n";
     oss << "└─────────────┘\n\n";
 
-    if (state.accepted) {
+    if (step.status == SimulationTrace::Accepted) {
         oss << "\nParsing successful - input accepted!\n";
-    } else if (state.error) {
+    } else if (step.status == SimulationTrace::Rejected) {
         oss << "\nError: No action defined for current state and symbol\n";
     }
 
@@ -395,88 +574,11 @@ std::string CanonicalLRParser::getCurrentStepOutput() const {
 void CanonicalLRParser::nextStep() {
     if (!hasNextStep()) return;
 
-    if (currentSimulationStep == simulationStates.size() - 1) {
+    if (currentSimulationStep == trace.size() - 1) {
         // Need to compute next step
-        const SimulationState& currentState = simulationStates.back();
-        SimulationState newState = currentState;
-
-        int currentStackState = newState.stateStack.top();
-        std::string currentSymbol;
-
-        // Get next input symbol
-        std::ifstream inputFile("input.txt");
-        std::string input;
-        if (inputFile.is_open()) {
-            std::getline(inputFile, input);
-            inputFile.close();
-        }
-        std::istringstream iss(input);
-        std::string token;
-        size_t pos = 0;
-        while (iss >> token) {
-            if (pos == newState.inputPointer) {
-                currentSymbol = token;
-                break;
-            }
-            pos++;
-        }
-        if (currentSymbol.empty()) {
-            currentSymbol = "$";
-        }
-
-        // Check for valid action
-        if (actionTable[currentStackState].count(currentSymbol) == 0) {
-            newState.error = true;
-            simulationStates.push_back(newState);
-            currentSimulationStep++;
-            return;
-        }
-
-        std::string action = actionTable[currentStackState][currentSymbol];
-        newState.currentAction = action;
-
-        if (action == "acc") {
-            newState.accepted = true;
-        }
-        else if (action[0] == 's') {
-            // Shift action
-            int nextState = std::stoi(action.substr(1));
-            newState.stateStack.push(nextState);
-            newState.symbolStack.push(currentSymbol);
-            newState.inputPointer++;
-        }
-        else if (action[0] == 'r') {
-            // Reduce action
-            int ruleNumber = std::stoi(action.substr(1));
-
-            // Find the production to reduce by
-            bool found = false;
-            int currentRule = 0;
-            for (const auto& production : augmentedGrammar->getAugmentedProductions()) {
-                const std::string& lhs = production.first;
-                for (const auto& rhs : production.second) {
-                    if (currentRule == ruleNumber) {
-                        // Pop symbols from stacks
-                        for (size_t i = 0; i < rhs.size(); ++i) {
-                            if (!newState.symbolStack.empty()) newState.symbolStack.pop();
-                            if (!newState.stateStack.empty()) newState.stateStack.pop();
-                        }
-
-                        // Push LHS and new state
-                        newState.symbolStack.push(lhs);
-                        int newStackState = newState.stateStack.top();
-                        newState.stateStack.push(gotoTable[newStackState][lhs]);
-
-                        found = true;
-                        break;
-                    }
-                    currentRule++;
-                }
-                if (found) break;
-            }
-        }
-
-        simulationStates.push_back(newState);
+        size_t position = trace.last().inputPointer;
+        int terminal = position < simulationTokens.size() ? simulationTokens[position] : SymbolTable::endMarker;
+        trace.advance(*tables, terminal);
     }
 
     currentSimulationStep++;
@@ -488,6 +590,21 @@ void CanonicalLRParser::previousStep() {
     }
 }
 
+void CanonicalLRParser::goToStep(size_t step) {
+    while (currentSimulationStep < step && hasNextStep()) {
+        nextStep();
+    }
+    currentSimulationStep = std::min(step, currentSimulationStep);
+}
+
+size_t CanonicalLRParser::getCurrentStep() const {
+    return currentSimulationStep;
+}
+
+size_t CanonicalLRParser::getComputedSteps() const {
+    return trace.size();
+}
+
 void CanonicalLRParser::resetSimulation() {
     currentSimulationStep = 0;
 }
@@ -4,47 +4,92 @@
 #include "GrammarInput.h"
 #include "AugmentedGrammar.h"
 #include "FirstFollow.h"
+#include "Grammar.h"
 #include "ItemSetGenerator.h"
+#include "ParseTables.h"
+#include "TableCache.h"
+#include "SimulationTrace.h"
+#include "TokenBuffer.h"
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
-#include <stack>
 #include <sstream>
 
 class CanonicalLRParser {
 private:
     GrammarInput grammarInput;
-    AugmentedGrammar* augmentedGrammar;
-    FirstFollow* firstFollow;
-    ItemSetGenerator* itemSetGenerator;
+    std::string grammarFile;
+    std::string inputPath;
+    std::unique_ptr<FirstFollow> firstFollow;             // from the last full or incremental build
+    std::unique_ptr<ItemSetGenerator> itemSetGenerator;   // ...the base for the next incremental one
+    SharedGrammar grammar;            // augmented; shared by every stage of run()
     std::ostringstream outputStream;  // Add this line
 
-    std::map<int, std::map<std::string, std::string>> actionTable;
-    std::map<int, std::map<std::string, int>> gotoTable;
+    SharedParseTables tables;  // null until generateParseTable() or a cache hit
+    bool compressTables;
+    ConstructionMode constructionMode;
+    unsigned threadCount;
+    TableCache* tableCache;    // optional, not owned
+    std::string cacheKey;
+    bool tablesFromCache;      // run() found the tables; skip building them
+    bool incremental;
+    bool lazyConstruction;
+    bool lazyTables;           // the last run() left the item sets to parsing
     /*****************************/
     // Simulation state
-    struct SimulationState {
-        std::stack<int> stateStack;
-        std::stack<std::string> symbolStack;
-        size_t inputPointer;
-        std::string currentAction;
-        bool accepted;
-        bool error;
-    };
-
-    std::vector<SimulationState> simulationStates;
+    SimulationTrace trace;                     // steps computed so far
+    TokenBuffer simulationInput;               // set by setInput() or read by prepareSimulation()
+    bool inputFromFile;                        // read simulationInput from inputPath
+    std::vector<int> simulationTokens;         // ...as terminal IDs
     size_t currentSimulationStep;
     /********************************/
 
+    void buildParseTable();  // from the item sets of the last run(); sets `tables`
+
 public:
     CanonicalLRParser();
     ~CanonicalLRParser();
 
     void run();
+    void setGrammarFile(const std::string& path);     // applies from the next run()
+    void setInputFile(const std::string& path);       // read by the step simulation
+    void setInput(std::string text);                  // simulate this text instead of a file
+    // Reuse tables generated earlier for the same grammar and mode; run()
+    // then skips FIRST/FOLLOW and item set construction on a hit.
+    void setTableCache(TableCache* cache);
+    // Incremental regeneration (on by default): run() diffs the grammar
+    // against the previous build and recomputes only the FIRST/FOLLOW sets
+    // and LR(1) closures the edit can affect.
+    void setIncremental(bool enabled);
+    // Lazy construction (canonical LR(1) only; off by default): run() skips
+    // item set construction, and the tables from generateParseTable() build
+    // each state the first time a parse reaches it (see LazyAutomaton.h).
+    // They are not displayed or cached.
+    void setLazyConstruction(bool enabled);           // applies from the next run()
+    void setConstructionMode(ConstructionMode mode);  // applies from the next run()
+    void setThreadCount(unsigned threads);            // 0 = all cores
     std::string getOutput() const;  // Add this method declaration
     void clearOutput();
 
     void generateParseTable();
+    ParseTable::Result parse(const std::vector<std::string>& tokens) const;
+
+    // Optional row-displacement compression of the generated tables; when
+    // enabled, parse() runs on the compressed form.
+    void setTableCompression(bool enabled);
+    size_t getRawTableBytes() const;
+    size_t getCompressedTableBytes() const;  // 0 unless compression is enabled
+
+    // Immutable tables from the last generateParseTable(), for BatchParser
+    // and other drivers; they stay valid after this parser is rerun or gone.
+    SharedParseTables getTables() const;
+    // Rule number of `lhs -> rhs` in those tables (an empty rhs is the ε
+    // rule), e.g. to register SemanticActions; -1 if there is no such rule
+    int getRuleNumber(const std::string& lhs, const std::vector<std::string>& rhs) const;
+    // Writes those tables as a C++ header with a built-in driver (see
+    // CodeGenerator.h)
+    void generateHeader(const std::string& path, const std::string& nameSpace) const;
     void simulateParser();
     /*****************************/
     void prepareSimulation();  // Initialize simulation states
@@ -53,6 +98,11 @@ public:
     std::string getCurrentStepOutput() const;
     void nextStep();
     void previousStep();
+    // Steps are computed on demand, so this can run ahead of the trace;
+    // stops at the last step if the parse ends before `step`
+    void goToStep(size_t step);
+    size_t getCurrentStep() const;
+    size_t getComputedSteps() const;
     void resetSimulation();
     /*****************************/
 };
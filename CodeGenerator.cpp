@@ -0,0 +1,691 @@
+// CodeGenerator.cpp
+#include "CodeGenerator.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+const char* punctuationName(char c) {
+    switch (c) {
+    case '+': return "PLUS";
+    case '-': return "MINUS";
+    case '*': return "STAR";
+    case '/': return "SLASH";
+    case '%': return "PERCENT";
+    case '(': return "LPAREN";
+    case ')': return "RPAREN";
+    case '[': return "LBRACKET";
+    case ']': return "RBRACKET";
+    case '{': return "LBRACE";
+    case '}': return "RBRACE";
+    case '<': return "LT";
+    case '>': return "GT";
+    case '=': return "EQUALS";
+    case '!': return "BANG";
+    case '&': return "AMP";
+    case '|': return "BAR";
+    case '^': return "CARET";
+    case '~': return "TILDE";
+    case '.': return "DOT";
+    case ',': return "COMMA";
+    case ';': return "SEMI";
+    case ':': return "COLON";
+    case '?': return "QUESTION";
+    case '@': return "AT";
+    case '#': return "HASH";
+    case '$': return "END";
+    case '\'': return "PRIME";
+    case '"': return "QUOTE";
+    case '\\': return "BACKSLASH";
+    case '`': return "BACKTICK";
+    default: return nullptr;
+    }
+}
+
+// T_<name> or N_<name>. The prefix keeps it clear of keywords and of names
+// reserved for leading underscores; runs of '_' collapse, since any name
+// with "__" in it is reserved too.
+std::string identifierFor(const std::string& name, bool terminal) {
+    std::string id = terminal ? "T" : "N";
+    auto append = [&id](char c) {
+        if (c != '_' || id.back() != '_') id += c;
+    };
+    bool separate = true;   // an '_' is due before the next word
+    for (unsigned char c : name) {
+        if (std::isalnum(c) || c == '_') {
+            if (separate) append('_');
+            append(static_cast<char>(c));
+            separate = false;
+            continue;
+        }
+        const char* word = punctuationName(static_cast<char>(c));
+        append('_');
+        if (word) {
+            id += word;
+        } else {
+            static const char hex[] = "0123456789ABCDEF";
+            id += 'x';
+            id += hex[c >> 4];
+            id += hex[c & 15];
+        }
+        separate = true;
+    }
+    return id;
+}
+
+// A C++ string literal; octal escapes have a fixed width, so a following
+// digit can't extend them the way it would a hex escape
+std::string quoted(const std::string& text) {
+    std::string literal = "\"";
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            literal += '\\';
+            literal += static_cast<char>(c);
+        } else if (c < 0x20 || c >= 0x7F || c == '?') {
+            literal += '\\';
+            literal += static_cast<char>('0' + (c >> 6));
+            literal += static_cast<char>('0' + ((c >> 3) & 7));
+            literal += static_cast<char>('0' + (c & 7));
+        } else {
+            literal += static_cast<char>(c);
+        }
+    }
+    return literal + "\"";
+}
+
+// A symbol name for a `//` comment; one with a backslash is quoted, since a
+// trailing backslash would continue the comment onto the next line
+std::string commentName(const std::string& name) {
+    return name.find('\\') == std::string::npos ? name : quoted(name);
+}
+
+// `inline constexpr <type> <name>[] = { ... };`, 16 values per line. An
+// empty array gets one `filler` entry, since C++ has no zero-length arrays.
+template <typename T>
+void writeArray(std::ostream& os, const char* type, const char* name, const std::vector<T>& values, T filler) {
+    os << "inline constexpr " << type << " " << name << "[] = {";
+    if (values.empty()) {
+        os << " " << filler << " };\n";
+        return;
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        os << (i % 16 == 0 ? "\n    " : " ") << values[i] << ",";
+    }
+    os << "\n};\n";
+}
+
+}
+
+CodeGenerator::CodeGenerator(const ParseTables& tables, const std::string& nameSpace, const std::string& source)
+    : tables(tables), nameSpace(nameSpace), source(source) {
+    if (tables.isLazy()) {
+        throw std::runtime_error("Lazily built parse tables cannot be generated as code");
+    }
+    bool valid = !nameSpace.empty() && !std::isdigit(static_cast<unsigned char>(nameSpace[0]));
+    for (unsigned char c : nameSpace) {
+        valid &= std::isalnum(c) || c == '_' || c == ':';
+    }
+    if (!valid) {
+        throw std::runtime_error("Invalid namespace '" + nameSpace + "'");
+    }
+
+    const SymbolTable& symbols = tables.symbols();
+    std::set<std::string> used;
+    for (int id = 0; id < symbols.size(); ++id) {
+        const std::string spelled = identifierFor(symbols.name(id), symbols.isTerminal(id));
+        // Names that spell the same get the symbol ID appended, and if some
+        // other symbol is spelled like that, a larger number
+        const std::string stem = spelled.back() == '_' ? spelled : spelled + "_";
+        std::string identifier = spelled;
+        for (int suffix = id; !used.insert(identifier).second; suffix += symbols.size()) {
+            identifier = stem + std::to_string(suffix);
+        }
+        identifiers.push_back(identifier);
+    }
+}
+
+namespace {
+
+template <typename Write>
+void writeFile(const std::string& path, Write write) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not write '" + path + "'");
+    }
+    write(file);
+    if (!file) {
+        throw std::runtime_error("Could not write '" + path + "'");
+    }
+}
+
+}
+
+void CodeGenerator::writeTableHeader(const std::string& path) const {
+    writeFile(path, [this](std::ostream& os) { writeTableHeader(os); });
+}
+
+void CodeGenerator::writeDirectHeader(const std::string& path) const {
+    writeFile(path, [this](std::ostream& os) { writeDirectHeader(os); });
+}
+
+// Everything both header kinds share: symbols, rules, terminal lookup and
+// the listener and result types
+void CodeGenerator::writePrologue(std::ostream& os) const {
+    const SymbolTable& symbols = tables.symbols();
+    const ParseTableView& table = tables.table();
+
+    os << "// Generated by CLRParserGUI from " << source << "; do not edit.\n"
+       << "#pragma once\n"
+       << "#include <algorithm>\n"
+       << "#include <cstddef>\n"
+       << "#include <cstdint>\n"
+       << "#include <string_view>\n"
+       << "#include <vector>\n\n"
+       << "namespace " << nameSpace << " {\n\n";
+
+    // Symbols
+    os << "enum Symbol : int {\n";
+    for (int id = 0; id < symbols.size(); ++id) {
+        os << "    " << identifiers[id] << " = " << id << ",\n";
+    }
+    os << "};\n\n"
+       << "inline constexpr int terminalCount = " << symbols.terminalCount() << ";\n"
+       << "inline constexpr int nonTerminalCount = " << symbols.nonTerminalCount() << ";\n"
+       << "inline constexpr int stateCount = " << table.stateCount() << ";\n"
+       << "inline constexpr int ruleCount = " << table.ruleCount() << ";\n\n";
+
+    os << "inline constexpr const char* symbolNames[] = {";
+    for (int id = 0; id < symbols.size(); ++id) {
+        os << (id % 8 == 0 ? "\n    " : " ") << quoted(symbols.name(id)) << ",";
+    }
+    os << "\n};\n\n";
+
+    std::vector<std::pair<std::string, int>> byName;
+    for (int terminal = 0; terminal < symbols.terminalCount(); ++terminal) {
+        byName.emplace_back(symbols.name(terminal), terminal);
+    }
+    std::sort(byName.begin(), byName.end());
+    os << "struct NamedTerminal {\n"
+       << "    std::string_view name;\n"
+       << "    int id;\n"
+       << "};\n\n"
+       << "// Sorted by name, for terminal()\n"
+       << "inline constexpr NamedTerminal terminalsByName[] = {\n";
+    for (const auto& named : byName) {
+        os << "    {" << quoted(named.first) << ", " << identifiers[named.second] << "},\n";
+    }
+    os << "};\n\n";
+
+    // Rules, as ParseTable::Rule
+    os << "struct Rule {\n"
+       << "    int32_t lhs;      // non-terminal index\n"
+       << "    int32_t length;\n"
+       << "};\n\n"
+       << "// By rule number\n"
+       << "inline constexpr Rule rules[] = {";
+    if (table.ruleCount() == 0) {
+        os << " {0, 0} };\n";
+    } else {
+        for (int rule = 0; rule < table.ruleCount(); ++rule) {
+            os << (rule % 8 == 0 ? "\n    " : " ")
+               << "{" << table.ruleLhs(rule) << ", " << table.ruleLength(rule) << "},";
+        }
+        os << "\n};\n";
+    }
+
+    os << R"(
+// Terminal ID of a token's text, or -1 if it names no terminal
+inline int terminal(std::string_view text) {
+    auto found = std::lower_bound(std::begin(terminalsByName), std::end(terminalsByName), text,
+                                  [](const NamedTerminal& entry, std::string_view key) { return entry.name < key; });
+    return found != std::end(terminalsByName) && found->name == text ? found->id : -1;
+}
+
+// Listener hooks called by parse(); symbols are IDs and `position` is the
+// index of the next unread token
+struct NoListener {
+    void shift(int /*terminal*/, size_t /*position*/) {}
+    void reduce(int /*rule*/, int /*lhs*/, int /*length*/, size_t /*position*/) {}
+    void accept() {}
+};
+
+struct Result {
+    bool accepted = false;
+    size_t errorPosition = 0;   // offending token, `count` for the end marker
+    size_t actions = 0;
+};
+
+// Conflicts resolved by precedence can leave the automaton reducing forever
+// without reading a token. reduce() reports that, as in runLRParser(), once
+// the stack has risen more levels above its lowest point since the last
+// shift than there are states, or has come back to an earlier configuration
+// without sinking lower in between.
+class ReductionGuard {
+public:
+    explicit ReductionGuard(size_t height) { shift(height); }
+
+    void shift(size_t height) {
+        floor = height;
+        reductions = 0;
+        nextSnapshot = firstSnapshot;
+    }
+
+    bool reduce(const std::vector<int>& stack, int rule) {
+        if (stack.size() < floor) {
+            shift(stack.size());   // the stack can only sink so far, so start over
+        } else if (stack.size() - floor > static_cast<size_t>(stateCount)) {
+            return true;
+        }
+        if (++reductions < firstSnapshot) return false;
+        // Below the top of the lowest stack nothing has changed since
+        const auto from = stack.begin() + (floor > 0 ? floor - 1 : 0);
+        if (reductions == nextSnapshot) {
+            snapshot.assign(from, stack.end());
+            snapshotRule = rule;
+            nextSnapshot *= 2;
+            return false;
+        }
+        return rule == snapshotRule && std::equal(from, stack.end(), snapshot.begin(), snapshot.end());
+    }
+
+private:
+    static constexpr size_t firstSnapshot = 64;
+    size_t floor = 0;
+    size_t reductions = 0;
+    size_t nextSnapshot = firstSnapshot;
+    std::vector<int> snapshot;
+    int snapshotRule = -1;
+};
+)";
+}
+
+void CodeGenerator::writeEpilogue(std::ostream& os) const {
+    os << R"(
+inline Result parse(const std::vector<int>& tokens, std::vector<int>& stack) {
+    NoListener listener;
+    return parse(tokens.data(), tokens.size(), stack, listener);
+}
+
+)";
+    os << "}  // namespace " << nameSpace << "\n";
+}
+
+void CodeGenerator::writeTableHeader(std::ostream& os) const {
+    const CompressedParseTable packed(tables.table());
+
+    writePrologue(os);
+
+    os << "\n// ACTION words keep their kind in the top two bits and the target\n"
+       << "// state or rule number in the rest. Rows are overlaid at per-state\n"
+       << "// offsets; an entry belongs to a state when its check matches, and\n"
+       << "// any other lookup gets the state's default.\n";
+    writeArray<uint32_t>(os, "uint32_t", "defaultAction", packed.defaultAction, 0);
+    writeArray<uint32_t>(os, "uint32_t", "actionBase", packed.actionBase, 0);
+    writeArray<uint32_t>(os, "uint32_t", "actionValue", packed.actionValue, 0);
+    writeArray<uint16_t>(os, "uint16_t", "actionCheck", packed.actionCheck, 0xFFFF);
+    os << "\n// GOTO columns per non-terminal, packed the same way with states in\n"
+       << "// the check array\n";
+    writeArray<int>(os, "int32_t", "defaultGoto", packed.defaultGoto, -1);
+    writeArray<uint32_t>(os, "uint32_t", "gotoBase", packed.gotoBase, 0);
+    writeArray<int>(os, "int32_t", "gotoValue", packed.gotoValue, -1);
+    writeArray<int>(os, "int32_t", "gotoCheck", packed.gotoCheck, -1);
+
+    os << R"(
+enum ActionKind : uint32_t { Error = 0, Shift = 1, Reduce = 2, Accept = 3 };
+
+constexpr ActionKind kind(uint32_t action) { return static_cast<ActionKind>(action >> 30); }
+constexpr int value(uint32_t action) { return static_cast<int>(action & 0x3FFFFFFF); }
+
+constexpr uint32_t action(int state, int terminal) {
+    size_t i = static_cast<size_t>(actionBase[state]) + terminal;
+    return actionCheck[i] == terminal ? actionValue[i] : defaultAction[state];
+}
+
+constexpr int gotoState(int state, int nonTerminal) {
+    size_t i = static_cast<size_t>(gotoBase[nonTerminal]) + state;
+    return gotoCheck[i] == state ? gotoValue[i] : defaultGoto[nonTerminal];
+}
+
+// Parses terminal IDs (the end marker is implied after the last one and
+// negative IDs are unknown tokens). `stack` is scratch space the caller may
+// reuse across calls.
+template <typename Listener>
+Result parse(const int* tokens, size_t count, std::vector<int>& stack, Listener& listener) {
+    Result result;
+    stack.clear();
+    stack.push_back(0);
+    size_t position = 0;
+    ReductionGuard guard(stack.size());
+
+    while (true) {
+        int next = position < count ? tokens[position] : 0;
+        uint32_t act = (next >= 0 && next < terminalCount) ? action(stack.back(), next) : 0;
+        result.actions++;
+
+        switch (kind(act)) {
+        case Shift:
+            stack.push_back(value(act));
+            listener.shift(next, position);
+            position++;
+            guard.shift(stack.size());
+            break;
+        case Reduce: {
+            int number = value(act);
+            const Rule& rule = rules[number];
+            stack.resize(stack.size() - rule.length);
+            stack.push_back(gotoState(stack.back(), rule.lhs));
+            listener.reduce(number, terminalCount + rule.lhs, rule.length, position);
+            if (guard.reduce(stack, number)) {
+                result.errorPosition = position;
+                return result;
+            }
+            break;
+        }
+        case Accept:
+            result.accepted = true;
+            listener.accept();
+            return result;
+        default:
+            result.errorPosition = position;
+            return result;
+        }
+    }
+}
+)";
+
+    writeEpilogue(os);
+}
+
+// One labelled block per state: push it, then switch on the lookahead and
+// jump straight to the next state, a reduction, accept or error. Each
+// reduction pops its right-hand side and jumps to its left-hand side's GOTO
+// block, which switches on the uncovered state. As in the compressed tables,
+// a state's most frequent reduction by a non-empty rule is its default case,
+// so an error can show up a few reductions late but at the same token.
+void CodeGenerator::writeDirectHeader(std::ostream& os) const {
+    const SymbolTable& symbols = tables.symbols();
+    const ParseTableView& table = tables.table();
+    const int states = table.stateCount();
+    const int terminals = table.terminalCount();
+    const int nonTerminals = table.nonTerminalCount();
+
+    // Work out the jumps first, so only referenced labels are emitted
+    std::vector<ParseTable::Action> defaults(states, ParseTable::makeAction(ParseTable::Error, 0));
+    std::vector<bool> stateUsed(states, false);   // jumped to; state 0 is entered directly
+    std::vector<bool> reduceUsed(table.ruleCount(), false);
+    bool acceptUsed = false;
+    bool errorUsed = false;
+    for (int state = 0; state < states; ++state) {
+        std::map<ParseTable::Action, int> reductions;
+        for (int terminal = 0; terminal < terminals; ++terminal) {
+            ParseTable::Action action = table.action(state, terminal);
+            if (ParseTable::kind(action) == ParseTable::Reduce) reductions[action]++;
+        }
+        int best = 0;
+        for (const auto& reduction : reductions) {
+            if (table.ruleLength(ParseTable::value(reduction.first)) == 0) continue;
+            if (reduction.second > best) {
+                best = reduction.second;
+                defaults[state] = reduction.first;
+            }
+        }
+        errorUsed |= ParseTable::kind(defaults[state]) == ParseTable::Error;
+
+        for (int terminal = 0; terminal < terminals; ++terminal) {
+            ParseTable::Action action = table.action(state, terminal);
+            switch (ParseTable::kind(action)) {
+            case ParseTable::Shift: stateUsed[ParseTable::value(action)] = true; break;
+            case ParseTable::Reduce: reduceUsed[ParseTable::value(action)] = true; break;
+            case ParseTable::Accept: acceptUsed = true; break;
+            default: break;
+            }
+        }
+    }
+    std::vector<bool> gotoUsed(nonTerminals, false);
+    for (int rule = 0; rule < table.ruleCount(); ++rule) {
+        if (!reduceUsed[rule]) continue;
+        gotoUsed[table.ruleLhs(rule)] = true;
+        errorUsed = true;   // by the reduction guard
+    }
+    std::vector<int> defaultGoto(nonTerminals, -1);
+    for (int nonTerminal = 0; nonTerminal < nonTerminals; ++nonTerminal) {
+        if (!gotoUsed[nonTerminal]) continue;
+        std::map<int, int> targets;
+        for (int state = 0; state < states; ++state) {
+            int target = table.gotoState(state, nonTerminal);
+            if (target >= 0) targets[target]++;
+        }
+        int best = 0;
+        for (const auto& target : targets) {
+            stateUsed[target.first] = true;
+            if (target.second > best) {
+                best = target.second;
+                defaultGoto[nonTerminal] = target.first;
+            }
+        }
+    }
+
+    writePrologue(os);
+    os << R"(
+// Directly executable parser: the automaton as code, with no table lookups.
+// Parses terminal IDs (the end marker is implied after the last one and
+// negative IDs are unknown tokens). `stack` is scratch space the caller may
+// reuse across calls.
+template <typename Listener>
+Result parse(const int* tokens, size_t count, std::vector<int>& stack, Listener& listener) {
+    Result result;
+    stack.clear();
+    size_t position = 0;
+    // Heights as of the reductions, which come before the GOTO target pushes
+    // itself
+    ReductionGuard guard(0);
+    auto read = [tokens, count](size_t at) {
+        int token = at < count ? tokens[at] : 0;
+        return token >= 0 && token < terminalCount ? token : -1;
+    };
+    int next = read(0);
+)";
+
+    auto jump = [&](ParseTable::Action action) -> std::string {
+        switch (ParseTable::kind(action)) {
+        case ParseTable::Shift:
+            return "listener.shift(next, position); next = read(++position); guard.shift(stack.size()); "
+                   "goto state_" + std::to_string(ParseTable::value(action)) + ";";
+        case ParseTable::Reduce: return "goto reduce_" + std::to_string(ParseTable::value(action)) + ";";
+        case ParseTable::Accept: return "goto accept;";
+        default: return "goto error;";
+        }
+    };
+
+    for (int state = 0; state < states; ++state) {
+        if (state > 0 && !stateUsed[state]) continue;
+        os << "\n";
+        if (stateUsed[state]) os << "state_" << state << ":\n";
+        os << "    stack.push_back(" << state << ");\n"
+           << "    result.actions++;\n"
+           << "    switch (next) {\n";
+        // Terminals grouped by action, in order of first appearance
+        std::vector<std::pair<ParseTable::Action, std::vector<int>>> groups;
+        std::map<ParseTable::Action, size_t> groupOf;
+        for (int terminal = 0; terminal < terminals; ++terminal) {
+            ParseTable::Action action = table.action(state, terminal);
+            if (ParseTable::kind(action) == ParseTable::Error || action == defaults[state]) continue;
+            auto found = groupOf.emplace(action, groups.size());
+            if (found.second) groups.push_back({action, {}});
+            groups[found.first->second].second.push_back(terminal);
+        }
+        for (const auto& group : groups) {
+            for (int terminal : group.second) {
+                os << "    case " << identifiers[terminal] << ":\n";
+            }
+            os << "        " << jump(group.first) << "\n";
+        }
+        os << "    default:\n"
+           << "        " << jump(defaults[state]) << "\n"
+           << "    }\n";
+    }
+
+    for (int rule = 0; rule < table.ruleCount(); ++rule) {
+        if (!reduceUsed[rule]) continue;
+        int length = table.ruleLength(rule);
+        int lhs = table.ruleLhs(rule);
+        os << "\nreduce_" << rule << ":  // " << commentName(symbols.name(terminals + lhs)) << " ->";
+        if (length == 0) {
+            os << " " << SymbolTable::epsilon;
+        } else if (const Grammar* grammar = tables.grammar()) {
+            for (int symbol : grammar->productions()[rule].rhs) {
+                os << " " << commentName(symbols.name(symbol));
+            }
+        } else {
+            // A loaded table file keeps only the length of each rule
+            os << " (" << length << (length == 1 ? " symbol)" : " symbols)");
+        }
+        os << "\n";
+        if (length > 0) {
+            os << "    stack.resize(stack.size() - " << length << ");\n";
+        }
+        os << "    listener.reduce(" << rule << ", " << identifiers[terminals + lhs] << ", " << length
+           << ", position);\n"
+           << "    if (guard.reduce(stack, " << rule << ")) goto error;\n"
+           << "    goto goto_" << lhs << ";\n";
+    }
+
+    for (int nonTerminal = 0; nonTerminal < nonTerminals; ++nonTerminal) {
+        if (!gotoUsed[nonTerminal]) continue;
+        os << "\ngoto_" << nonTerminal << ":  // " << commentName(symbols.name(terminals + nonTerminal)) << "\n"
+           << "    switch (stack.back()) {\n";
+        std::map<int, std::vector<int>> byTarget;
+        for (int state = 0; state < states; ++state) {
+            int target = table.gotoState(state, nonTerminal);
+            if (target >= 0 && target != defaultGoto[nonTerminal]) byTarget[target].push_back(state);
+        }
+        for (const auto& target : byTarget) {
+            for (int state : target.second) {
+                os << "    case " << state << ":\n";
+            }
+            os << "        goto state_" << target.first << ";\n";
+        }
+        os << "    default:\n"
+           << "        goto state_" << defaultGoto[nonTerminal] << ";\n"
+           << "    }\n";
+    }
+
+    if (acceptUsed) {
+        os << "\naccept:\n"
+           << "    result.accepted = true;\n"
+           << "    listener.accept();\n"
+           << "    return result;\n";
+    }
+    if (errorUsed) {
+        os << "\nerror:\n"
+           << "    result.errorPosition = position;\n"
+           << "    return result;\n";
+    }
+    os << "}\n";
+
+    writeEpilogue(os);
+}
+
+void CodeGenerator::writeBenchmark(std::ostream& os, const std::string& tableHeader, const std::string& tableNamespace,
+                                   const std::string& directHeader, const std::string& directNamespace) {
+    os << "// Generated by CLRParserGUI; do not edit.\n"
+       << "// Usage: benchmark <input> [repeat]. The input has one token sequence\n"
+       << "// per line, parsed by the table-driven and the directly executable\n"
+       << "// parser, which must agree on every line.\n"
+       << "#include \"" << tableHeader << "\"\n"
+       << "#include \"" << directHeader << "\"\n"
+       << "namespace table_driven = " << tableNamespace << ";\n"
+       << "namespace direct = " << directNamespace << ";\n";
+    os << R"(#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Also counts the accepted sequences over all rounds, which keeps the parses
+// from being optimized away and is printed as a cross-check
+template <typename Parse>
+double tokensPerSecond(const std::vector<std::vector<int>>& lines, size_t tokens, int repeat, Parse parse,
+                       size_t& accepted) {
+    std::vector<int> stack;
+    accepted = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < repeat; ++round) {
+        for (const auto& line : lines) {
+            accepted += parse(line, stack).accepted;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds > 0 ? tokens * repeat / seconds : 0.0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <input> [repeat]\n";
+        return 2;
+    }
+    std::ifstream input(argv[1]);
+    if (!input.is_open()) {
+        std::cerr << "Error: Could not open file '" << argv[1] << "'\n";
+        return 1;
+    }
+    int repeat = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    std::vector<std::vector<int>> lines;
+    size_t tokens = 0;
+    std::string text;
+    while (std::getline(input, text)) {
+        std::istringstream words(text);
+        std::vector<int> line;
+        std::string word;
+        while (words >> word) line.push_back(table_driven::terminal(word));
+        tokens += line.size();
+        lines.push_back(std::move(line));
+    }
+
+    std::vector<int> stack;
+    size_t accepted = 0;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        table_driven::Result expected = table_driven::parse(lines[i], stack);
+        direct::Result actual = direct::parse(lines[i], stack);
+        if (expected.accepted != actual.accepted ||
+            (!expected.accepted && expected.errorPosition != actual.errorPosition)) {
+            std::cerr << "Line " << i + 1 << ": the parsers disagree\n";
+            return 1;
+        }
+        accepted += expected.accepted;
+    }
+
+    size_t tableAccepted = 0;
+    size_t directAccepted = 0;
+    double tableRate = tokensPerSecond(lines, tokens, repeat, [](const std::vector<int>& line, std::vector<int>& s) {
+        return table_driven::parse(line, s);
+    }, tableAccepted);
+    double directRate = tokensPerSecond(lines, tokens, repeat, [](const std::vector<int>& line, std::vector<int>& s) {
+        return direct::parse(line, s);
+    }, directAccepted);
+    std::cout << lines.size() << " sequences (" << accepted << " accepted), " << tokens << " tokens x "
+              << repeat << "\n"
+              << "table-driven: " << tableRate / 1e6 << " M tokens/s, " << tableAccepted << " accepted\n"
+              << "direct:       " << directRate / 1e6 << " M tokens/s, " << directAccepted << " accepted ("
+              << (tableRate > 0 ? directRate / tableRate : 0.0) << "x)\n";
+    return tableAccepted == directAccepted ? 0 : 1;
+}
+)";
+}
+
+void CodeGenerator::writeBenchmark(const std::string& path, const std::string& tableHeader,
+                                   const std::string& tableNamespace, const std::string& directHeader,
+                                   const std::string& directNamespace) {
+    writeFile(path, [&](std::ostream& os) {
+        writeBenchmark(os, tableHeader, tableNamespace, directHeader, directNamespace);
+    });
+}
@@ -0,0 +1,52 @@
+// CodeGenerator.h
+#pragma once
+#include "ParseTables.h"
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Emits parse tables as C++ source, so a parser can be compiled into a
+// program with no generation or loading work at runtime: either the tables
+// themselves with a driver loop, or the automaton as straight-line code.
+class CodeGenerator {
+public:
+    // `nameSpace` wraps everything emitted; `source` names the grammar in
+    // the generated file's header comment
+    CodeGenerator(const ParseTables& tables, const std::string& nameSpace, const std::string& source);
+
+    // A self-contained header: a Symbol enum, the rule table and the
+    // row-displacement compressed ACTION/GOTO arrays (see
+    // CompressedParseTable.h) as constexpr data, terminal lookup by name,
+    // and a templated driver that calls the same listener hooks as
+    // runLRParser() (see LRDriver.h).
+    void writeTableHeader(std::ostream& os) const;
+    void writeTableHeader(const std::string& path) const;
+
+    // The same prologue with a directly executable parser instead of the
+    // arrays: every state is a block of code that switches on the lookahead
+    // and jumps to the next one, so parsing does no table lookups
+    void writeDirectHeader(std::ostream& os) const;
+    void writeDirectHeader(const std::string& path) const;
+
+    // A program that checks a table-driven and a directly executable header
+    // for the same grammar agree on an input file and times both
+    static void writeBenchmark(std::ostream& os, const std::string& tableHeader, const std::string& tableNamespace,
+                               const std::string& directHeader, const std::string& directNamespace);
+    static void writeBenchmark(const std::string& path, const std::string& tableHeader,
+                               const std::string& tableNamespace, const std::string& directHeader,
+                               const std::string& directNamespace);
+
+    // C++ identifier for each symbol, by ID: T_<name> for terminals and
+    // N_<name> for non-terminals, with punctuation spelled out and runs of
+    // '_' collapsed. Names that would clash get a numeric suffix.
+    const std::vector<std::string>& enumNames() const { return identifiers; }
+
+private:
+    const ParseTables& tables;
+    std::string nameSpace;
+    std::string source;
+    std::vector<std::string> identifiers;
+
+    void writePrologue(std::ostream& os) const;
+    void writeEpilogue(std::ostream& os) const;
+};
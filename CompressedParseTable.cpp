@@ -0,0 +1,156 @@
+// CompressedParseTable.cpp
+#include "CompressedParseTable.h"
+#include "LRDriver.h"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+typedef std::vector<std::pair<int, uint32_t>> SparseRow;  // (column, value)
+
+// First-fit row displacement. Every distinct row gets its own base so that a
+// matching check value identifies the owning row; identical rows share one.
+// Value/check arrays are padded so base + column never runs past the end.
+template <typename Value, typename Check>
+void packRows(const std::vector<SparseRow>& rows, int columns, Check unused,
+              std::vector<uint32_t>& base, std::vector<Value>& values, std::vector<Check>& check) {
+    std::vector<size_t> order(rows.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return rows[a].size() > rows[b].size();  // densest rows first
+    });
+
+    std::map<SparseRow, uint32_t> placed;
+    std::vector<bool> baseUsed;
+    base.assign(rows.size(), 0);
+    size_t firstFree = 0;
+
+    for (size_t index : order) {
+        const SparseRow& row = rows[index];
+        auto existing = placed.find(row);
+        if (existing != placed.end()) {
+            base[index] = existing->second;
+            continue;
+        }
+
+        int lowest = row.empty() ? 0 : row.front().first;
+        size_t candidate = firstFree > static_cast<size_t>(lowest) ? firstFree - lowest : 0;
+        while (true) {
+            bool fits = candidate >= baseUsed.size() || !baseUsed[candidate];
+            for (size_t e = 0; fits && e < row.size(); ++e) {
+                size_t slot = candidate + row[e].first;
+                fits = slot >= check.size() || check[slot] == unused;
+            }
+            if (fits) break;
+            candidate++;
+        }
+
+        if (candidate >= baseUsed.size()) baseUsed.resize(candidate + 1, false);
+        baseUsed[candidate] = true;
+        if (check.size() < candidate + columns) {
+            check.resize(candidate + columns, unused);
+            values.resize(candidate + columns, Value());
+        }
+        for (const auto& entry : row) {
+            check[candidate + entry.first] = static_cast<Check>(entry.first);
+            values[candidate + entry.first] = static_cast<Value>(entry.second);
+        }
+        while (firstFree < check.size() && check[firstFree] != unused) firstFree++;
+
+        base[index] = static_cast<uint32_t>(candidate);
+        placed.emplace(row, static_cast<uint32_t>(candidate));
+    }
+}
+
+}
+
+CompressedParseTable::CompressedParseTable(const ParseTableView& table)
+    : terminals(table.terminalCount()) {
+    // Check values are 16-bit terminal IDs with 0xFFFF marking free slots
+    if (terminals >= 0xFFFF) {
+        throw std::runtime_error("Cannot compress parse tables with " + std::to_string(terminals) +
+                                 " terminals; at most 65534 are supported");
+    }
+    int states = table.stateCount();
+    int nonTerminals = table.nonTerminalCount();
+
+    // ACTION: default reduction per state, remaining entries as sparse rows
+    std::vector<SparseRow> actionRows(states);
+    defaultAction.assign(states, ParseTable::makeAction(ParseTable::Error, 0));
+    for (int state = 0; state < states; ++state) {
+        std::map<ParseTable::Action, int> reductions;
+        for (int terminal = 0; terminal < terminals; ++terminal) {
+            ParseTable::Action action = table.action(state, terminal);
+            if (ParseTable::kind(action) == ParseTable::Reduce) reductions[action]++;
+        }
+        // The most frequent reduction replaces the state's error entries, so
+        // a state that only reduces by one rule needs no row at all. Errors
+        // are then caught before the next shift instead of immediately. An ε
+        // rule is never the default: on an erroneous token, ε reductions
+        // could push states forever without reaching that shift.
+        int best = 0;
+        for (const auto& reduction : reductions) {
+            if (table.ruleLength(ParseTable::value(reduction.first)) == 0) continue;
+            if (reduction.second > best) {
+                best = reduction.second;
+                defaultAction[state] = reduction.first;
+            }
+        }
+
+        for (int terminal = 0; terminal < terminals; ++terminal) {
+            ParseTable::Action action = table.action(state, terminal);
+            if (ParseTable::kind(action) != ParseTable::Error && action != defaultAction[state]) {
+                actionRows[state].emplace_back(terminal, action);
+            }
+        }
+    }
+    packRows(actionRows, terminals, static_cast<uint16_t>(0xFFFF), actionBase, actionValue, actionCheck);
+
+    // GOTO: default target per non-terminal, remaining entries per column
+    std::vector<SparseRow> gotoColumns(nonTerminals);
+    defaultGoto.assign(nonTerminals, -1);
+    for (int nonTerminal = 0; nonTerminal < nonTerminals; ++nonTerminal) {
+        std::map<int, int> targets;
+        for (int state = 0; state < states; ++state) {
+            int target = table.gotoState(state, nonTerminal);
+            if (target >= 0) targets[target]++;
+        }
+        int best = 0;
+        for (const auto& target : targets) {
+            if (target.second > best) {
+                best = target.second;
+                defaultGoto[nonTerminal] = target.first;
+            }
+        }
+        for (int state = 0; state < states; ++state) {
+            int target = table.gotoState(state, nonTerminal);
+            if (target >= 0 && target != defaultGoto[nonTerminal]) {
+                gotoColumns[nonTerminal].emplace_back(state, static_cast<uint32_t>(target));
+            }
+        }
+    }
+    packRows(gotoColumns, states, -1, gotoBase, gotoValue, gotoCheck);
+
+    rules.reserve(table.ruleCount());
+    for (int rule = 0; rule < table.ruleCount(); ++rule) {
+        rules.push_back(table.rule(rule));
+    }
+}
+
+size_t CompressedParseTable::byteSize() const {
+    return defaultAction.size() * sizeof(ParseTable::Action) +
+           actionBase.size() * sizeof(uint32_t) +
+           actionValue.size() * sizeof(ParseTable::Action) +
+           actionCheck.size() * sizeof(uint16_t) +
+           defaultGoto.size() * sizeof(int) +
+           gotoBase.size() * sizeof(uint32_t) +
+           gotoValue.size() * sizeof(int) +
+           gotoCheck.size() * sizeof(int) +
+           rules.size() * sizeof(ParseTable::Rule);
+}
+
+ParseTable::Result CompressedParseTable::parse(const std::vector<int>& tokens, std::vector<int>& stack) const {
+    return runLRParser(*this, tokens, stack);
+}
@@ -0,0 +1,60 @@
+// CompressedParseTable.h
+#pragma once
+#include "ParseTable.h"
+#include <cstdint>
+#include <vector>
+
+// Row-displacement ("comb vector") packing of a ParseTable.
+//
+// ACTION: each state gets a default action (its most frequent reduction by a
+// non-empty rule, or error), and only the entries that differ from it are
+// stored. Rows are
+// overlaid into one value/check array pair at per-state offsets; an entry at
+// base[state] + terminal belongs to that state when its check equals the
+// terminal. Identical rows share an offset.
+//
+// GOTO: each non-terminal gets a default target (its most frequent one), and
+// the remaining entries are packed the same way with columns as rows and
+// states in the check array.
+//
+// ACTION checks are 16 bits wide, so the constructor throws
+// std::runtime_error for tables with 65535 or more terminals.
+class CompressedParseTable {
+public:
+    CompressedParseTable() = default;
+    explicit CompressedParseTable(const ParseTableView& table);
+
+    ParseTable::Action action(int state, int terminal) const {
+        size_t i = static_cast<size_t>(actionBase[state]) + terminal;
+        return actionCheck[i] == terminal ? actionValue[i] : defaultAction[state];
+    }
+    int gotoState(int state, int nonTerminal) const {
+        size_t i = static_cast<size_t>(gotoBase[nonTerminal]) + state;
+        return gotoCheck[i] == state ? gotoValue[i] : defaultGoto[nonTerminal];
+    }
+
+    int stateCount() const { return static_cast<int>(defaultAction.size()); }
+    int terminalCount() const { return terminals; }
+    int nonTerminalCount() const { return static_cast<int>(defaultGoto.size()); }
+    const ParseTable::Rule& rule(int rule) const { return rules[rule]; }
+    int ruleLhs(int rule) const { return rules[rule].lhs; }
+    int ruleLength(int rule) const { return rules[rule].length; }
+
+    size_t byteSize() const;
+
+    ParseTable::Result parse(const std::vector<int>& tokens, std::vector<int>& stack) const;
+
+private:
+    friend class CodeGenerator;   // emits these arrays as C++ source
+
+    int terminals = 0;
+    std::vector<ParseTable::Action> defaultAction;   // by state
+    std::vector<uint32_t> actionBase;                // by state
+    std::vector<ParseTable::Action> actionValue;
+    std::vector<uint16_t> actionCheck;               // terminal ID, 0xFFFF if unused
+    std::vector<int> defaultGoto;                    // by non-terminal
+    std::vector<uint32_t> gotoBase;                  // by non-terminal
+    std::vector<int> gotoValue;
+    std::vector<int> gotoCheck;                      // state, -1 if unused
+    std::vector<ParseTable::Rule> rules;             // by rule number
+};
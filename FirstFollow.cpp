@@ -2,152 +2,307 @@
 #include "FirstFollow.h"
 #include <iostream>
 #include <algorithm>
+#include <climits>
+#include <utility>
 
-FirstFollow::FirstFollow(const std::map<std::string, std::vector<std::vector<std::string>>>& prod)
-    : productions(prod) {}
+FirstFollow::FirstFollow(SharedGrammar sharedGrammar)
+    : grammar(std::move(sharedGrammar)), symbols(grammar->symbols()), productions(grammar->productions()) {}
 
-void FirstFollow::computeFirst() {
-    // Initialize FIRST sets for all non-terminals
-    for (std::map<std::string, std::vector<std::vector<std::string>>>::const_iterator it = productions.begin();
-         it != productions.end(); ++it) {
-        first[it->first] = std::set<std::string>();
+// Linear-time nullable computation: each production counts the right-hand
+// side non-terminals not yet known to be nullable and fires when it hits 0.
+// Only `affected` non-terminals are computed; the others must already hold
+// their final value.
+void FirstFollow::computeNullable(const std::vector<bool>& affected) {
+    int nonTerminals = symbols.nonTerminalCount();
+    std::vector<int> pending(productions.size(), 0);
+    std::vector<std::vector<int>> occurrences(nonTerminals);
+    std::vector<int> worklist;
+
+    for (size_t p = 0; p < productions.size(); ++p) {
+        int lhs = nonTerminalIndex(productions[p].lhs);
+        if (!affected[lhs]) continue;
+
+        bool blocked = false;
+        for (int symbol : productions[p].rhs) {
+            if (symbols.isTerminal(symbol)) {
+                blocked = true;
+            } else if (!affected[nonTerminalIndex(symbol)]) {
+                blocked |= !nullable[nonTerminalIndex(symbol)];
+            } else {
+                pending[p]++;
+                occurrences[nonTerminalIndex(symbol)].push_back(static_cast<int>(p));
+            }
+        }
+
+        if (blocked) {
+            pending[p] = -1;  // can never derive ε
+        } else if (pending[p] == 0 && !nullable[lhs]) {
+            nullable[lhs] = true;
+            worklist.push_back(lhs);
+        }
     }
 
-    bool changed = true;
-    while (changed) {
-        changed = false;
-        for (std::map<std::string, std::vector<std::vector<std::string>>>::const_iterator prodIt = productions.begin();
-             prodIt != productions.end(); ++prodIt) {
-            const std::string& nonTerminal = prodIt->first;
-            const std::vector<std::vector<std::string>>& rules = prodIt->second;
-
-            for (std::vector<std::vector<std::string>>::const_iterator ruleIt = rules.begin();
-                 ruleIt != rules.end(); ++ruleIt) {
-                const std::vector<std::string>& rule = *ruleIt;
-                std::set<std::string> result = computeFirstOfString(rule);
-                size_t before = first[nonTerminal].size();
-                first[nonTerminal].insert(result.begin(), result.end());
-                if (first[nonTerminal].size() > before) {
-                    changed = true;
-                }
+    while (!worklist.empty()) {
+        int nonTerminal = worklist.back();
+        worklist.pop_back();
+        for (int p : occurrences[nonTerminal]) {
+            int lhs = nonTerminalIndex(productions[p].lhs);
+            if (pending[p] > 0 && --pending[p] == 0 && !nullable[lhs]) {
+                nullable[lhs] = true;
+                worklist.push_back(lhs);
             }
         }
     }
 }
 
-std::set<std::string> FirstFollow::computeFirstOfString(const std::vector<std::string>& str) {
-    std::set<std::string> result;
-    if (str.empty()) {
-        result.insert("ε");
-        return result;
-    }
+// DeRemer-Pennello digraph: computes F(x) = F'(x) ∪ ⋃{ F(y) | x R y } where
+// `sets` holds F' on entry. Each strongly connected component of R is found
+// once and all of its members receive the same final set, so every set is
+// finished in a single traversal instead of a global fixpoint.
+void FirstFollow::digraph(const std::vector<std::vector<int>>& relation, std::vector<Bitset>& sets) {
+    struct Traversal {
+        const std::vector<std::vector<int>>& relation;
+        std::vector<Bitset>& sets;
+        std::vector<int> depth;
+        std::vector<int> stack;
+
+        void traverse(int x) {
+            stack.push_back(x);
+            int d = static_cast<int>(stack.size());
+            depth[x] = d;
+
+            for (int y : relation[x]) {
+                if (depth[y] == 0) traverse(y);
+                depth[x] = std::min(depth[x], depth[y]);
+                sets[x].unite(sets[y]);
+            }
 
-    for (size_t i = 0; i < str.size(); ++i) {
-        const std::string& symbol = str[i];
-        
-        if (productions.find(symbol) == productions.end()) {
-            result.insert(symbol);
-            break;
-        }
-        
-        const std::set<std::string>& firstSet = first[symbol];
-        result.insert(firstSet.begin(), firstSet.end());
-        
-        if (firstSet.find("ε") == firstSet.end()) {
-            break;
-        }
-        
-        if (i == str.size() - 1) {
-            result.insert("ε");
-        } else {
-            result.erase("ε");
+            if (depth[x] == d) {
+                // x is the root of its component: finalize every member
+                while (true) {
+                    int top = stack.back();
+                    stack.pop_back();
+                    depth[top] = INT_MAX;
+                    if (top == x) break;
+                    sets[top] = sets[x];
+                }
+            }
         }
+    };
+
+    Traversal traversal = {relation, sets, std::vector<int>(sets.size(), 0), {}};
+    for (size_t x = 0; x < sets.size(); ++x) {
+        if (traversal.depth[x] == 0) traversal.traverse(static_cast<int>(x));
     }
-    return result;
 }
 
+void FirstFollow::computeFirst() {
+    std::vector<bool> all(symbols.nonTerminalCount(), true);
+    nullable.assign(all.size(), false);
+    first.assign(all.size(), Bitset(symbols.terminalCount()));
+    computeNullable(all);
+    computeFirstSets(all);
+}
 
 void FirstFollow::computeFollow(const std::string& startSymbol) {
-    // Initialize FOLLOW sets for all non-terminals
-    for (std::map<std::string, std::vector<std::vector<std::string>>>::const_iterator it = productions.begin();
-         it != productions.end(); ++it) {
-        follow[it->first] = std::set<std::string>();
+    std::vector<bool> all(symbols.nonTerminalCount(), true);
+    follow.assign(all.size(), Bitset(symbols.terminalCount()));
+    computeFollowSets(symbols.id(startSymbol), all);
+}
+
+// FIRST for the `affected` non-terminals (with nullable already final);
+// the other sets must already be final.
+void FirstFollow::computeFirstSets(const std::vector<bool>& affected) {
+    // FIRST(A) includes FIRST(B) for every A -> α B β with α nullable
+    std::vector<std::vector<int>> includes(symbols.nonTerminalCount());
+    for (const auto& production : productions) {
+        int lhs = nonTerminalIndex(production.lhs);
+        if (!affected[lhs]) continue;
+        for (int symbol : production.rhs) {
+            if (symbols.isTerminal(symbol)) {
+                first[lhs].set(symbol);
+                break;
+            }
+            int B = nonTerminalIndex(symbol);
+            if (affected[B]) {
+                includes[lhs].push_back(B);
+            } else {
+                first[lhs].unite(first[B]);
+            }
+            if (!nullable[B]) break;
+        }
+    }
+
+    digraph(includes, first);
+}
+
+// FOLLOW for the `affected` non-terminals, which must start out empty; the
+// other sets must already be final.
+void FirstFollow::computeFollowSets(int start, const std::vector<bool>& affected) {
+    if (start >= 0 && !symbols.isTerminal(start) && affected[nonTerminalIndex(start)]) {
+        follow[nonTerminalIndex(start)].set(SymbolTable::endMarker);
     }
-    follow[startSymbol].insert("$");
-
-    bool changed = true;
-    while (changed) {
-        changed = false;
-        for (std::map<std::string, std::vector<std::vector<std::string>>>::const_iterator prodIt = productions.begin();
-             prodIt != productions.end(); ++prodIt) {
-            const std::string& lhs = prodIt->first;
-            const std::vector<std::vector<std::string>>& rules = prodIt->second;
-
-            for (std::vector<std::vector<std::string>>::const_iterator ruleIt = rules.begin();
-                 ruleIt != rules.end(); ++ruleIt) {
-                const std::vector<std::string>& rule = *ruleIt;
-                
-                for (size_t i = 0; i < rule.size(); ++i) {
-                    const std::string& B = rule[i];
-                    if (productions.find(B) == productions.end()) continue;
-
-                    size_t before = follow[B].size();
-                    
-                    if (i + 1 < rule.size()) {
-                        std::vector<std::string> beta(rule.begin() + i + 1, rule.end());
-                        std::set<std::string> firstBeta = computeFirstOfString(beta);
-                        
-                        for (std::set<std::string>::const_iterator fIt = firstBeta.begin();
-                             fIt != firstBeta.end(); ++fIt) {
-                            if (*fIt != "ε") {
-                                follow[B].insert(*fIt);
-                            }
-                        }
-                        
-                        if (firstBeta.find("ε") != firstBeta.end()) {
-                            follow[B].insert(follow[lhs].begin(), follow[lhs].end());
-                        }
+
+    // For A -> α B β: FOLLOW(B) gets FIRST(β), and includes FOLLOW(A) if β is
+    // nullable. Walking each right-hand side backwards keeps FIRST(β) and its
+    // nullability as a running value.
+    std::vector<std::vector<int>> includes(symbols.nonTerminalCount());
+    Bitset trailer(symbols.terminalCount());
+    for (const auto& production : productions) {
+        trailer.clear();
+        bool suffixNullable = true;
+        int A = nonTerminalIndex(production.lhs);
+
+        for (size_t i = production.rhs.size(); i-- > 0;) {
+            int symbol = production.rhs[i];
+            if (symbols.isTerminal(symbol)) {
+                trailer.clear();
+                trailer.set(symbol);
+                suffixNullable = false;
+                continue;
+            }
+
+            int B = nonTerminalIndex(symbol);
+            if (affected[B]) {
+                follow[B].unite(trailer);
+                if (suffixNullable) {
+                    if (affected[A]) {
+                        includes[B].push_back(A);
                     } else {
-                        follow[B].insert(follow[lhs].begin(), follow[lhs].end());
-                    }
-                    
-                    if (follow[B].size() > before) {
-                        changed = true;
+                        follow[B].unite(follow[A]);
                     }
                 }
             }
+
+            if (nullable[B]) {
+                trailer.unite(first[B]);
+            } else {
+                trailer = first[B];
+                suffixNullable = false;
+            }
         }
     }
+
+    digraph(includes, follow);
 }
 
-void FirstFollow::displayFirstFollow(std::ostream& os) const {
-    std::cout << "\nFIRST sets:\n";
-    for (std::map<std::string, std::set<std::string>>::const_iterator it = first.begin();
-         it != first.end(); ++it) {
-        std::cout << "FIRST(" << it->first << ") = { ";
-        for (std::set<std::string>::const_iterator symIt = it->second.begin();
-             symIt != it->second.end(); ++symIt) {
-            std::cout << *symIt << " ";
-        }
-        std::cout << "}\n";
+void FirstFollow::computeIncremental(const FirstFollow& previous, const GrammarDiff& diff,
+                                     const std::string& startSymbol) {
+    const int nonTerminals = symbols.nonTerminalCount();
+    nullable.assign(nonTerminals, false);
+    first.assign(nonTerminals, Bitset(symbols.terminalCount()));
+    follow.assign(nonTerminals, Bitset(symbols.terminalCount()));
+
+    // FIRST and nullable of A can change only if A derives a changed
+    // non-terminal: walk "is used by" edges back from the changed ones.
+    std::vector<std::vector<int>> usedBy(nonTerminals);
+    for (const auto& production : productions) {
+        for (int symbol : production.rhs) {
+            if (!symbols.isTerminal(symbol)) {
+                usedBy[nonTerminalIndex(symbol)].push_back(nonTerminalIndex(production.lhs));
+            }
+        }
+    }
+    std::vector<bool> firstAffected(nonTerminals, false);
+    std::vector<int> worklist;
+    for (int n = 0; n < nonTerminals; ++n) {
+        if (diff.changed(n)) {
+            firstAffected[n] = true;
+            worklist.push_back(n);
+        }
+    }
+    while (!worklist.empty()) {
+        int n = worklist.back();
+        worklist.pop_back();
+        for (int user : usedBy[n]) {
+            if (!firstAffected[user]) {
+                firstAffected[user] = true;
+                worklist.push_back(user);
+            }
+        }
     }
 
-    std::cout << "\nFOLLOW sets:\n";
-    for (std::map<std::string, std::set<std::string>>::const_iterator it = follow.begin();
-         it != follow.end(); ++it) {
-        std::cout << "FOLLOW(" << it->first << ") = { ";
-        for (std::set<std::string>::const_iterator symIt = it->second.begin();
-             symIt != it->second.end(); ++symIt) {
-            std::cout << *symIt << " ";
+    for (int n = 0; n < nonTerminals; ++n) {
+        if (!firstAffected[n]) {
+            int old = diff.previousNonTerminal(n);
+            nullable[n] = previous.nullable[old];
+            first[n] = diff.remap(previous.first[old]);
         }
-        std::cout << "}\n";
     }
+    computeNullable(firstAffected);
+    computeFirstSets(firstAffected);
+
+    // FOLLOW(B) can change if B appears in a changed rule or next to a
+    // non-terminal whose FIRST may have changed, and then so can the FOLLOW
+    // of everything that inherits FOLLOW(B) at the end of B's rules.
+    std::vector<bool> followAffected(nonTerminals, false);
+    for (int n : diff.touched()) {
+        followAffected[n] = true;
+    }
+    std::vector<std::vector<int>> inheritedBy(nonTerminals);
+    for (const auto& production : productions) {
+        bool nearChange = false;
+        for (int symbol : production.rhs) {
+            nearChange |= !symbols.isTerminal(symbol) && firstAffected[nonTerminalIndex(symbol)];
+        }
+        for (size_t i = production.rhs.size(); i-- > 0;) {
+            int symbol = production.rhs[i];
+            if (symbols.isTerminal(symbol)) break;
+            inheritedBy[nonTerminalIndex(production.lhs)].push_back(nonTerminalIndex(symbol));
+            if (!nullable[nonTerminalIndex(symbol)]) break;
+        }
+        if (!nearChange) continue;
+        for (int symbol : production.rhs) {
+            if (!symbols.isTerminal(symbol)) followAffected[nonTerminalIndex(symbol)] = true;
+        }
+    }
+    for (int n = 0; n < nonTerminals; ++n) {
+        if (followAffected[n]) worklist.push_back(n);
+    }
+    while (!worklist.empty()) {
+        int n = worklist.back();
+        worklist.pop_back();
+        for (int heir : inheritedBy[n]) {
+            if (!followAffected[heir]) {
+                followAffected[heir] = true;
+                worklist.push_back(heir);
+            }
+        }
+    }
+
+    for (int n = 0; n < nonTerminals; ++n) {
+        if (!followAffected[n]) {
+            follow[n] = diff.remap(previous.follow[diff.previousNonTerminal(n)]);
+        }
+    }
+    computeFollowSets(symbols.id(startSymbol), followAffected);
 }
 
-std::map<std::string, std::set<std::string>> FirstFollow::getFirst() const {
+void FirstFollow::displayFirstFollow(std::ostream& os) const {
+    auto displaySets = [&](const char* title, const std::vector<Bitset>& sets, bool showNullable) {
+        os << "\n" << title << " sets:\n";
+        for (size_t nt = 0; nt < sets.size(); ++nt) {
+            os << title << "(" << symbols.name(symbols.terminalCount() + static_cast<int>(nt)) << ") = { ";
+            sets[nt].forEach([&](size_t terminal) {
+                os << symbols.name(static_cast<int>(terminal)) << " ";
+            });
+            if (showNullable && nullable[nt]) os << SymbolTable::epsilon << " ";
+            os << "}\n";
+        }
+    };
+
+    displaySets("FIRST", first, true);
+    displaySets("FOLLOW", follow, false);
+}
+
+const std::vector<Bitset>& FirstFollow::getFirst() const {
     return first;
 }
 
-std::map<std::string, std::set<std::string>> FirstFollow::getFollow() const {
+const std::vector<Bitset>& FirstFollow::getFollow() const {
     return follow;
 }
+
+const std::vector<bool>& FirstFollow::getNullable() const {
+    return nullable;
+}
@@ -1,24 +1,40 @@
 // FirstFollow.h
 #pragma once
-#include <map>
-#include <set>
+#include "Bitset.h"
+#include "Grammar.h"
+#include "GrammarDiff.h"
 #include <string>
 #include <vector>
 
+// FIRST, FOLLOW and nullable over interned terminal IDs. Sets are indexed by
+// non-terminal index (symbol ID - terminalCount()).
 class FirstFollow {
 public:
-    FirstFollow(const std::map<std::string, std::vector<std::vector<std::string>>>& prod);
+    explicit FirstFollow(SharedGrammar grammar);
     void computeFirst();
     void computeFollow(const std::string& startSymbol);
+    // Both of the above after a grammar edit: only sets that can depend on
+    // a changed rule are recomputed, the rest are carried over from
+    // `previous` (the sets of the grammar before the edit).
+    void computeIncremental(const FirstFollow& previous, const GrammarDiff& diff,
+                            const std::string& startSymbol);
     void displayFirstFollow(std::ostream& os) const;
 
-    std::map<std::string, std::set<std::string>> getFirst() const;
-    std::map<std::string, std::set<std::string>> getFollow() const;
+    const std::vector<Bitset>& getFirst() const;
+    const std::vector<Bitset>& getFollow() const;
+    const std::vector<bool>& getNullable() const;
 
 private:
-    std::map<std::string, std::vector<std::vector<std::string>>> productions;
-    std::map<std::string, std::set<std::string>> first;
-    std::map<std::string, std::set<std::string>> follow;
+    SharedGrammar grammar;
+    const SymbolTable& symbols;                  // ...of `grammar`
+    const std::vector<Production>& productions;
+    std::vector<bool> nullable;
+    std::vector<Bitset> first;
+    std::vector<Bitset> follow;
 
-    std::set<std::string> computeFirstOfString(const std::vector<std::string>& str);
+    int nonTerminalIndex(int symbol) const { return symbol - symbols.terminalCount(); }
+    void computeNullable(const std::vector<bool>& affected);
+    void computeFirstSets(const std::vector<bool>& affected);
+    void computeFollowSets(int start, const std::vector<bool>& affected);
+    static void digraph(const std::vector<std::vector<int>>& relation, std::vector<Bitset>& sets);
 };
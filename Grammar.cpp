@@ -0,0 +1,21 @@
+// Grammar.cpp
+#include "Grammar.h"
+#include <stdexcept>
+
+Grammar::Grammar(const std::map<std::string, std::vector<std::vector<std::string>>>& prod)
+    : symbolTable(prod), rules(symbolTable.flatten(prod)), startSymbol(symbolTable.id("S'")) {
+    if (startSymbol < 0 || symbolTable.isTerminal(startSymbol)) {
+        throw std::runtime_error("Grammar has no augmented start rule S'");
+    }
+
+    // flatten() visits the non-terminals in ID order, so counting the rules
+    // of each gives where its range starts
+    const int terminalCount = symbolTable.terminalCount();
+    ruleBegin.assign(symbolTable.nonTerminalCount() + 1, 0);
+    for (const Production& production : rules) {
+        ruleBegin[production.lhs - terminalCount + 1]++;
+    }
+    for (size_t nonTerminal = 1; nonTerminal < ruleBegin.size(); ++nonTerminal) {
+        ruleBegin[nonTerminal] += ruleBegin[nonTerminal - 1];
+    }
+}
@@ -0,0 +1,55 @@
+// Grammar.h
+#pragma once
+#include "SymbolTable.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// An augmented grammar over interned symbols: the symbol table, the numbered
+// productions, and the rules of each non-terminal. It is built once per
+// grammar and never changes, so FIRST/FOLLOW, item set construction and the
+// parser share one instance (as SharedGrammar) instead of each converting
+// and keeping its own copy of the grammar.
+class Grammar {
+public:
+    // Rule numbers [first, last) of one non-terminal. Productions are
+    // numbered non-terminal by non-terminal, so a non-terminal's rules are
+    // always consecutive.
+    struct Rules {
+        struct iterator {
+            int rule;
+            int operator*() const { return rule; }
+            iterator& operator++() { ++rule; return *this; }
+            bool operator!=(const iterator& other) const { return rule != other.rule; }
+        };
+
+        int first;
+        int last;
+
+        iterator begin() const { return {first}; }
+        iterator end() const { return {last}; }
+        bool empty() const { return first == last; }
+        int size() const { return last - first; }
+    };
+
+    // `prod` must hold the augmented start rule S' -> S (see AugmentedGrammar)
+    explicit Grammar(const std::map<std::string, std::vector<std::vector<std::string>>>& prod);
+
+    const SymbolTable& symbols() const { return symbolTable; }
+    const std::vector<Production>& productions() const { return rules; }
+    int ruleCount() const { return static_cast<int>(rules.size()); }
+    int ruleLength(int rule) const { return static_cast<int>(rules[rule].rhs.size()); }
+    // By non-terminal index (symbol ID - terminalCount())
+    Rules rulesOf(int nonTerminal) const { return {ruleBegin[nonTerminal], ruleBegin[nonTerminal + 1]}; }
+
+    int augmentedStart() const { return startSymbol; }   // ID of S'
+
+private:
+    SymbolTable symbolTable;
+    std::vector<Production> rules;
+    std::vector<int> ruleBegin;   // by non-terminal index, then the rule count
+    int startSymbol;
+};
+
+typedef std::shared_ptr<const Grammar> SharedGrammar;
@@ -0,0 +1,116 @@
+// GrammarDiff.cpp
+#include "GrammarDiff.h"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace {
+
+// Rule text with symbols resolved to names, comparable across grammars. A
+// name that turned from terminal into non-terminal makes the rule differ.
+typedef std::vector<std::pair<bool, std::string>> RuleText;
+
+RuleText ruleText(const SymbolTable& symbols, const Production& production) {
+    RuleText text;
+    text.reserve(production.rhs.size() + 1);
+    text.emplace_back(false, symbols.name(production.lhs));
+    for (int symbol : production.rhs) {
+        text.emplace_back(symbols.isTerminal(symbol), symbols.name(symbol));
+    }
+    return text;
+}
+
+}
+
+GrammarDiff::GrammarDiff(const Grammar& before, const Grammar& after)
+    : newTerminalCount(after.symbols().terminalCount()) {
+    const SymbolTable& oldSymbols = before.symbols();
+    const SymbolTable& newSymbols = after.symbols();
+    const std::vector<Production>& oldProductions = before.productions();
+    const std::vector<Production>& newProductions = after.productions();
+    const int oldTerminals = oldSymbols.terminalCount();
+    const int newTerminals = newSymbols.terminalCount();
+
+    terminalMap.assign(oldTerminals, -1);
+    nonTerminalMap.assign(oldSymbols.nonTerminalCount(), -1);
+    previousNonTerminalMap.assign(newSymbols.nonTerminalCount(), -1);
+    for (int symbol = 0; symbol < oldSymbols.size(); ++symbol) {
+        int match = newSymbols.id(oldSymbols.name(symbol));
+        if (match < 0 || oldSymbols.isTerminal(symbol) != newSymbols.isTerminal(match)) continue;
+        if (oldSymbols.isTerminal(symbol)) {
+            terminalMap[symbol] = match;
+        } else {
+            nonTerminalMap[symbol - oldTerminals] = match - newTerminals;
+            previousNonTerminalMap[match - newTerminals] = symbol - oldTerminals;
+        }
+    }
+
+    // Pair identical rules; duplicates pair up in order
+    std::map<RuleText, std::vector<int>> unmatched;
+    for (size_t p = newProductions.size(); p-- > 0;) {
+        unmatched[ruleText(newSymbols, newProductions[p])].push_back(static_cast<int>(p));
+    }
+    productionMap.assign(oldProductions.size(), -1);
+    for (size_t p = 0; p < oldProductions.size(); ++p) {
+        auto match = unmatched.find(ruleText(oldSymbols, oldProductions[p]));
+        if (match != unmatched.end() && !match->second.empty()) {
+            productionMap[p] = match->second.back();
+            match->second.pop_back();
+        }
+    }
+
+    // A non-terminal changed if it is new or any of its old or new rules
+    // went unmatched
+    changedNonTerminals.assign(newSymbols.nonTerminalCount(), false);
+    for (int n = 0; n < newSymbols.nonTerminalCount(); ++n) {
+        changedNonTerminals[n] = previousNonTerminalMap[n] < 0;
+    }
+    std::vector<bool> matchedNew(newProductions.size(), false);
+    for (size_t p = 0; p < oldProductions.size(); ++p) {
+        if (productionMap[p] >= 0) {
+            matchedNew[productionMap[p]] = true;
+        } else {
+            int lhs = nonTerminalMap[oldProductions[p].lhs - oldTerminals];
+            if (lhs >= 0) changedNonTerminals[lhs] = true;
+        }
+    }
+    for (size_t p = 0; p < newProductions.size(); ++p) {
+        if (!matchedNew[p]) changedNonTerminals[newProductions[p].lhs - newTerminals] = true;
+    }
+
+    // Everything mentioned by a rule of a changed non-terminal, before or after
+    std::vector<bool> touched(newSymbols.nonTerminalCount(), false);
+    for (const Production& production : oldProductions) {
+        int lhs = nonTerminalMap[production.lhs - oldTerminals];
+        if (lhs >= 0 && !changedNonTerminals[lhs]) continue;
+        for (int symbol : production.rhs) {
+            if (oldSymbols.isTerminal(symbol)) continue;
+            int match = nonTerminalMap[symbol - oldTerminals];
+            if (match >= 0) touched[match] = true;
+        }
+    }
+    for (const Production& production : newProductions) {
+        int lhs = production.lhs - newTerminals;
+        if (!changedNonTerminals[lhs]) continue;
+        touched[lhs] = true;
+        for (int symbol : production.rhs) {
+            if (!newSymbols.isTerminal(symbol)) touched[symbol - newTerminals] = true;
+        }
+    }
+    for (int n = 0; n < newSymbols.nonTerminalCount(); ++n) {
+        if (touched[n]) touchedNonTerminals.push_back(n);
+    }
+}
+
+size_t GrammarDiff::changedCount() const {
+    return static_cast<size_t>(std::count(changedNonTerminals.begin(), changedNonTerminals.end(), true));
+}
+
+Bitset GrammarDiff::remap(const Bitset& oldTerminals) const {
+    Bitset terminals(newTerminalCount);
+    oldTerminals.forEach([&](size_t terminal) {
+        if (terminalMap[terminal] >= 0) terminals.set(terminalMap[terminal]);
+    });
+    return terminals;
+}
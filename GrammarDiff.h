@@ -0,0 +1,37 @@
+// GrammarDiff.h
+#pragma once
+#include "Bitset.h"
+#include "Grammar.h"
+#include <vector>
+
+// Correspondence between a grammar and an edited version of it. Symbols are
+// matched by name and rules by their text, so IDs and rule numbers may shift
+// freely between the two. A non-terminal is "changed" when its alternatives
+// differ as a multiset (reordering them does not count) or it is new.
+class GrammarDiff {
+public:
+    GrammarDiff(const Grammar& before, const Grammar& after);
+
+    // Old ID or number to new, -1 where the new grammar has no counterpart
+    int terminal(int oldTerminal) const { return terminalMap[oldTerminal]; }
+    int nonTerminal(int oldIndex) const { return nonTerminalMap[oldIndex]; }
+    int production(int oldProduction) const { return productionMap[oldProduction]; }
+    // New non-terminal index to old, -1 for non-terminals added by the edit
+    int previousNonTerminal(int newIndex) const { return previousNonTerminalMap[newIndex]; }
+
+    bool changed(int newIndex) const { return changedNonTerminals[newIndex]; }
+    size_t changedCount() const;
+    // New indices of every non-terminal on either side of a changed rule
+    const std::vector<int>& touched() const { return touchedNonTerminals; }
+
+    Bitset remap(const Bitset& oldTerminals) const;  // to new terminal IDs
+
+private:
+    int newTerminalCount;
+    std::vector<int> terminalMap;
+    std::vector<int> nonTerminalMap;
+    std::vector<int> productionMap;
+    std::vector<int> previousNonTerminalMap;
+    std::vector<bool> changedNonTerminals;
+    std::vector<int> touchedNonTerminals;
+};
@@ -4,16 +4,15 @@
 #include <sstream>
 #include <fstream>
 
-void GrammarInput::readGrammar() {
-    std::string filename = "grammar.txt";  // Default filename or get from config
+bool GrammarInput::readGrammar(const std::string& filename) {
+    productions.clear();
     std::ifstream infile(filename);
     
     if (!infile.is_open()) {
-        std::cerr << "Error: Could not open file '" << filename << "'\n";
-        return;
+        return false;
     }
 
-    std::cout << "Reading grammar from file: " << filename << "\n";
+    std::clog << "Reading grammar from file: " << filename << "\n";
     std::string line;
     
     while (std::getline(infile, line)) {
@@ -71,6 +70,7 @@ void GrammarInput::readGrammar() {
     }
     
     infile.close();
+    return true;
 }
 
 void GrammarInput::displayGrammar(std::ostream& os) const {
@@ -87,6 +87,6 @@ void GrammarInput::displayGrammar(std::ostream& os) const {
     }
 }
 
-std::map<std::string, std::vector<std::vector<std::string>>> GrammarInput::getProductions() const {
+const std::map<std::string, std::vector<std::vector<std::string>>>& GrammarInput::getProductions() const {
     return productions;
 }
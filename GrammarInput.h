@@ -7,9 +7,10 @@
 
 class GrammarInput {
 public:
-    void readGrammar();
+    // Returns false, leaving no productions, if the file can't be opened
+    bool readGrammar(const std::string& filename = "grammar.txt");
     void displayGrammar(std::ostream& os) const;
-    std::map<std::string, std::vector<std::vector<std::string>>> getProductions() const;
+    const std::map<std::string, std::vector<std::vector<std::string>>>& getProductions() const;
 
 private:
     std::map<std::string, std::vector<std::vector<std::string>>> productions;
@@ -0,0 +1,86 @@
+// ItemSet.cpp
+#include "ItemSet.h"
+#include <algorithm>
+#include <numeric>
+
+ItemSet::ItemSet(int terminalCount)
+    : stride(1 + (static_cast<size_t>(terminalCount) + 63) / 64) {}
+
+void ItemSet::add(uint32_t production, uint32_t dot, const Bitset& lookaheads) {
+    add(production, dot, lookaheads.data());
+}
+
+void ItemSet::add(uint32_t production, uint32_t dot, const uint64_t* lookaheads) {
+    words.push_back((static_cast<uint64_t>(production) << 32) | dot);
+    words.insert(words.end(), lookaheads, lookaheads + (stride - 1));
+}
+
+void ItemSet::finish() {
+    // GOTO kernels arrive in order already; closures need sorting
+    const size_t count = size();
+    bool ordered = true;
+    for (size_t i = 1; i < count && ordered; ++i) {
+        ordered = words[(i - 1) * stride] < words[i * stride];
+    }
+    if (!ordered) {
+        std::vector<uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return words[a * stride] < words[b * stride];
+        });
+        std::vector<uint64_t> sorted;
+        sorted.reserve(words.size());
+        for (uint32_t index : order) {
+            const uint64_t* item = &words[index * stride];
+            if (!sorted.empty() && sorted[sorted.size() - stride] == item[0]) {
+                uint64_t* into = &sorted[sorted.size() - stride];
+                for (size_t w = 1; w < stride; ++w) into[w] |= item[w];
+            } else {
+                sorted.insert(sorted.end(), item, item + stride);
+            }
+        }
+        words.swap(sorted);
+    }
+
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ words.size();
+    for (uint64_t word : words) {
+        h = (h ^ word) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+    hash = h;
+}
+
+bool ItemSet::merge(const ItemSet& other, ItemSet* added) {
+    if (added) {
+        added->clear();
+        added->stride = stride;
+    }
+    bool grew = false;
+    const size_t count = size();
+    size_t i = 0;
+    for (size_t j = 0; j < other.size(); ++j) {
+        const uint64_t* from = &other.words[j * stride];
+        while (i < count && words[i * stride] < from[0]) ++i;
+        if (i < count && words[i * stride] == from[0]) {
+            uint64_t* into = &words[i * stride];
+            size_t start = added ? added->words.size() : 0;
+            bool itemGrew = false;
+            if (added) added->words.push_back(from[0]);
+            for (size_t w = 1; w < stride; ++w) {
+                uint64_t bits = from[w] & ~into[w];
+                itemGrew |= bits != 0;
+                if (added) added->words.push_back(bits);
+                into[w] |= from[w];
+            }
+            if (added && !itemGrew) added->words.resize(start);
+            grew |= itemGrew;
+        } else {
+            words.insert(words.end(), from, from + stride);
+            if (added) added->words.insert(added->words.end(), from, from + stride);
+            grew = true;
+        }
+    }
+    if (added) added->finish();
+    if (grew) finish();
+    return grew;
+}
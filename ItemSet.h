@@ -0,0 +1,105 @@
+// ItemSet.h
+#pragma once
+#include "Bitset.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+// An LR(1) item as seen inside its ItemSet: the core (production index and
+// dot position) and all of its lookahead terminal IDs as bitset words, which
+// stay owned by the set. Symbols are resolved through the generator's
+// production list and SymbolTable.
+struct Item {
+    uint32_t production;
+    uint32_t dot;
+    const uint64_t* lookaheads;
+    size_t lookaheadWords;
+
+    uint64_t core() const { return (static_cast<uint64_t>(production) << 32) | dot; }
+    bool intersects(const Item& other) const {
+        for (size_t w = 0; w < lookaheadWords; ++w) {
+            if (lookaheads[w] & other.lookaheads[w]) return true;
+        }
+        return false;
+    }
+
+    // Calls f(terminal) for every lookahead in ascending order
+    template <typename F>
+    void forEachLookahead(F f) const {
+        for (size_t w = 0; w < lookaheadWords; ++w) {
+            uint64_t word = lookaheads[w];
+            while (word) {
+                f(w * 64 + static_cast<size_t>(lowestSetBit(word)));
+                word &= word - 1;
+            }
+        }
+    }
+};
+
+// A state's items (or kernel), one per core, sorted by core and stored in
+// one flat word array: each item's core followed by its lookahead words.
+// finish() puts the items in that canonical form and computes a 64-bit
+// fingerprint of the array, so two sets compare by fingerprint first and by
+// one memcmp only when the fingerprints match. A hash table of sets keys on
+// the fingerprint directly (ItemSetHash).
+class ItemSet {
+public:
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Item value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Item* pointer;
+        typedef Item reference;
+
+        const_iterator(const ItemSet* set, size_t index) : set(set), index(index) {}
+        Item operator*() const { return (*set)[index]; }
+        const_iterator& operator++() { ++index; return *this; }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+    private:
+        const ItemSet* set;
+        size_t index;
+    };
+
+    ItemSet() = default;
+    explicit ItemSet(int terminalCount);
+
+    // Appends an item; call finish() once all are added. Items may come in
+    // any order, and items with the same core are merged.
+    void add(uint32_t production, uint32_t dot, const Bitset& lookaheads);
+    void add(uint32_t production, uint32_t dot, const uint64_t* lookaheads);
+    void finish();
+    void clear() { words.clear(); hash = 0; }   // keeps the capacity for reuse
+
+    // Adds the lookaheads of `other` to the items with the same core (and
+    // the items this set lacks); returns false if nothing was added. With
+    // `added`, also replaces its contents with just what was new: one item
+    // per core that grew, carrying only the lookaheads it gained.
+    bool merge(const ItemSet& other, ItemSet* added = nullptr);
+
+    size_t size() const { return stride ? words.size() / stride : 0; }
+    bool empty() const { return words.empty(); }
+    Item operator[](size_t index) const {
+        const uint64_t* item = &words[index * stride];
+        return {static_cast<uint32_t>(item[0] >> 32), static_cast<uint32_t>(item[0]), item + 1, stride - 1};
+    }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    uint64_t fingerprint() const { return hash; }
+    bool operator==(const ItemSet& other) const { return hash == other.hash && words == other.words; }
+    bool operator!=(const ItemSet& other) const { return !(*this == other); }
+    size_t byteSize() const { return words.capacity() * sizeof(uint64_t); }
+
+private:
+    size_t stride = 0;              // words per item: the core, then the lookaheads
+    std::vector<uint64_t> words;
+    uint64_t hash = 0;
+};
+
+struct ItemSetHash {
+    size_t operator()(const ItemSet& items) const { return static_cast<size_t>(items.fingerprint()); }
+};
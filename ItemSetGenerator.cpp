@@ -1,178 +1,685 @@
 //ItemSetGenerator.cpp
 #include "ItemSetGenerator.h"
+#include "MemoryStats.h"
+#include "ThreadPool.h"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <utility>
 
-bool Item::operator<(const Item& other) const {
-    return std::tie(lhs, rhs, dot, lookahead) < std::tie(other.lhs, other.rhs, other.dot, other.lookahead);
+size_t CoreHash::operator()(const std::vector<uint64_t>& core) const {
+    std::hash<uint64_t> hashKey;
+    size_t seed = core.size();
+    for (uint64_t entry : core) {
+        seed ^= hashKey(entry) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+    return seed;
 }
 
-bool Item::operator==(const Item& other) const {
-    return lhs == other.lhs && rhs == other.rhs && dot == other.dot && lookahead == other.lookahead;
+const char* constructionModeName(ConstructionMode mode) {
+    switch (mode) {
+    case ConstructionMode::LALR1:
+        return "LALR(1)";
+    case ConstructionMode::MinimalLR1:
+        return "minimal LR(1)";
+    default:
+        return "canonical LR(1)";
+    }
 }
 
 ItemSetGenerator::ItemSetGenerator(
-    const std::map<std::string, std::vector<std::vector<std::string>>>& prod,
-    const std::map<std::string, std::set<std::string>>& firstMap
-) : productions(prod), first(firstMap) {}
+    SharedGrammar sharedGrammar,
+    const std::vector<Bitset>& firstSets,
+    const std::vector<bool>& nullableSet
+) : grammar(std::move(sharedGrammar)), symbols(grammar->symbols()), productions(grammar->productions()),
+    first(firstSets), nullable(nullableSet), mode(ConstructionMode::CanonicalLR1), threadCount(1) {
+    buildClosureTemplates();
+}
 
-void ItemSetGenerator::generateItemSets() {
-    // Initialize with augmented start symbol
-    Item startItem = {"S'", productions.at("S'")[0], 0, "$"};
-    std::set<Item> startSet = closure({startItem});
-    itemSets.push_back(startSet);
-
-    // Collect all grammar symbols
-    std::set<std::string> grammarSymbols;
-    for (const auto& production : productions) {
-        grammarSymbols.insert(production.first); // Non-terminals
-        for (const auto& rule : production.second) {
-            for (const auto& symbol : rule) {
-                grammarSymbols.insert(symbol); // Terminals
-            }
-        }
-    }
-
-    // Generate all item sets
-    bool changed = true;
-    while (changed) {
-        changed = false;
-        std::vector<std::set<Item>> currentItemSets = itemSets;
-        
-        for (size_t stateId = 0; stateId < itemSets.size(); ++stateId) {
-            for (const auto& symbol : grammarSymbols) {
-                std::set<Item> newState = gotoFunction(itemSets[stateId], symbol);
-                
-                if (!newState.empty()) {
-                    // Check if this state already exists
-                    auto existingState = std::find(
-                        currentItemSets.begin(),
-                        currentItemSets.end(),
-                        newState
-                    );
-                    
-                    int targetStateId;
-                    if (existingState == currentItemSets.end()) {
-                        currentItemSets.push_back(newState);
-                        targetStateId = currentItemSets.size() - 1;
-                        changed = true;
-                    } else {
-                        targetStateId = std::distance(currentItemSets.begin(), existingState);
+// Precomputes, per non-terminal, everything closing an item with the dot
+// before it adds, so that closure() is a few bitset unions per kernel item
+void ItemSetGenerator::buildClosureTemplates() {
+    const int terminalCount = symbols.terminalCount();
+    const int nonTerminalCount = symbols.nonTerminalCount();
+
+    // FIRST and nullability of every rule tail, built right to left
+    tailOffset.clear();
+    size_t positions = 0;
+    for (const Production& production : productions) {
+        tailOffset.push_back(positions);
+        positions += production.rhs.size();
+    }
+    tailFirst.assign(positions, Bitset(terminalCount));
+    tailNullable.assign(positions, true);
+    for (size_t p = 0; p < productions.size(); ++p) {
+        const std::vector<int>& rhs = productions[p].rhs;
+        Bitset suffix(terminalCount);
+        bool suffixNullable = true;
+        for (size_t pos = rhs.size(); pos-- > 0;) {
+            tailFirst[tailOffset[p] + pos] = suffix;
+            tailNullable[tailOffset[p] + pos] = suffixNullable;
+            if (symbols.isTerminal(rhs[pos])) {
+                suffix.clear();
+                suffix.set(rhs[pos]);
+                suffixNullable = false;
+            } else if (nullable[nonTerminalIndex(rhs[pos])]) {
+                suffix.unite(first[nonTerminalIndex(rhs[pos])]);
+            } else {
+                suffix = first[nonTerminalIndex(rhs[pos])];
+                suffixNullable = false;
+            }
+        }
+    }
+
+    // Non-terminals reachable through leftmost symbols (Warshall)
+    std::vector<Bitset> reach(nonTerminalCount, Bitset(nonTerminalCount));
+    for (int a = 0; a < nonTerminalCount; ++a) {
+        reach[a].set(a);
+        for (int p : grammar->rulesOf(a)) {
+            const std::vector<int>& rhs = productions[p].rhs;
+            if (!rhs.empty() && !symbols.isTerminal(rhs[0])) {
+                reach[a].set(nonTerminalIndex(rhs[0]));
+            }
+        }
+    }
+    for (int k = 0; k < nonTerminalCount; ++k) {
+        for (int a = 0; a < nonTerminalCount; ++a) {
+            if (reach[a].test(k)) {
+                reach[a].unite(reach[k]);
+            }
+        }
+    }
+
+    // Lookaheads within each reachable set, to a fixed point. A non-terminal
+    // with no lookahead adds no items, so it passes nothing on either.
+    closureTemplates.assign(nonTerminalCount, {});
+    std::vector<Bitset> lookaheads(nonTerminalCount);
+    std::vector<bool> propagates(nonTerminalCount);
+    for (int a = 0; a < nonTerminalCount; ++a) {
+        reach[a].forEach([&](size_t b) {
+            lookaheads[b] = Bitset(terminalCount);
+            propagates[b] = false;
+        });
+        propagates[a] = true;
+
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            reach[a].forEach([&](size_t b) {
+                if (!propagates[b] && lookaheads[b].empty()) return;
+                for (int p : grammar->rulesOf(static_cast<int>(b))) {
+                    const std::vector<int>& rhs = productions[p].rhs;
+                    if (rhs.empty() || symbols.isTerminal(rhs[0])) continue;
+                    int d = nonTerminalIndex(rhs[0]);
+                    changed |= lookaheads[d].unite(tailFirst[tailOffset[p]]);
+                    if (tailNullable[tailOffset[p]]) {
+                        changed |= lookaheads[d].unite(lookaheads[b]);
+                        if (propagates[b] && !propagates[d]) {
+                            propagates[d] = true;
+                            changed = true;
+                        }
                     }
-                    
-                    // Record the transition
-                    transitions[{static_cast<int>(stateId), symbol}] = targetStateId;
                 }
+            });
+        }
+
+        reach[a].forEach([&](size_t b) {
+            if (propagates[b] || !lookaheads[b].empty()) {
+                closureTemplates[a].push_back({static_cast<int>(b), propagates[b], std::move(lookaheads[b])});
+            }
+        });
+    }
+}
+
+void ItemSetGenerator::setConstructionMode(ConstructionMode newMode) {
+    mode = newMode;
+}
+
+ConstructionMode ItemSetGenerator::getConstructionMode() const {
+    return mode;
+}
+
+void ItemSetGenerator::setThreadCount(unsigned threads) {
+    threadCount = threads;
+}
+
+void ItemSetGenerator::generateItemSets() {
+    auto startTime = std::chrono::steady_clock::now();
+    kernels.clear();
+    itemSets.clear();
+    transitions.clear();
+    stats = ItemSetStats();
+    Scratch scratch(*this);
+
+    // Canonical states are indexed by their kernel: two LR(1) states are equal
+    // exactly when their kernels are, so closure() only runs for unseen
+    // kernels. Merging modes index states by core instead.
+    std::unordered_multimap<uint64_t, int> stateIndex;   // kernel fingerprint -> state
+    std::unordered_map<std::vector<uint64_t>, std::vector<int>, CoreHash> coreIndex;
+    std::deque<int> worklist;
+    std::vector<bool> queued;
+    std::vector<bool> expanded;
+    std::vector<ItemSet> unpropagated;   // by state: closed lookaheads its successors lack
+    ItemSet added;
+
+    auto addState = [&](ItemSet&& kernel) {
+        int stateId = static_cast<int>(itemSets.size());
+        itemSets.push_back(closeKernel(kernel, scratch, stats.closures, stats.reusedClosures));
+        if (mode == ConstructionMode::CanonicalLR1) {
+            stateIndex.emplace(kernel.fingerprint(), stateId);
+        } else {
+            coreIndex[coreOf(kernel)].push_back(stateId);
+        }
+        kernels.push_back(std::move(kernel));
+        worklist.push_back(stateId);
+        queued.push_back(true);
+        expanded.push_back(false);
+        unpropagated.emplace_back();
+        return stateId;
+    };
+
+    auto findState = [&](const ItemSet& kernel) {
+        if (mode == ConstructionMode::CanonicalLR1) {
+            auto candidates = stateIndex.equal_range(kernel.fingerprint());
+            for (auto candidate = candidates.first; candidate != candidates.second; ++candidate) {
+                if (kernels[candidate->second] == kernel) return candidate->second;
+            }
+            return -1;
+        }
+        auto sameCore = coreIndex.find(coreOf(kernel));
+        if (sameCore == coreIndex.end()) return -1;
+        for (int stateId : sameCore->second) {
+            if (mode == ConstructionMode::LALR1 || weaklyCompatible(kernels[stateId], kernel)) {
+                return stateId;
+            }
+        }
+        return -1;
+    };
+
+    // Merging new lookaheads into a state adds to its closure only what the
+    // new lookaheads close to: the closure's items and spontaneous lookaheads
+    // follow from the cores, which stay the same. An expanded state is queued
+    // again to pass that on to its successors.
+    auto mergeInto = [&](int stateId, const ItemSet& kernel) {
+        if (!kernels[stateId].merge(kernel, &added)) return;
+
+        stats.merges++;
+        stats.closures++;
+        const ItemSet& closed = closure(added, scratch);
+        itemSets[stateId].merge(closed);
+        if (!expanded[stateId]) return;
+        if (unpropagated[stateId].empty()) {
+            unpropagated[stateId] = closed;
+        } else {
+            unpropagated[stateId].merge(closed);
+        }
+        if (!queued[stateId]) {
+            queued[stateId] = true;
+            worklist.push_back(stateId);
+        }
+    };
+
+    unsigned threads = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    if (mode == ConstructionMode::CanonicalLR1 && threads > 1) {
+        generateCanonicalParallel(startKernel(), threads);
+    } else {
+        addState(startKernel());
+    }
+
+    // Worklist: every state is expanded exactly once, in discovery order;
+    // merging modes revisit a state when it gains lookaheads after that.
+    while (!worklist.empty()) {
+        int stateId = worklist.front();
+        worklist.pop_front();
+        queued[stateId] = false;
+
+        if (expanded[stateId]) {
+            // Revisit: the transition targets are fixed, only the new lookaheads flow
+            ItemSet closed = std::move(unpropagated[stateId]);
+            unpropagated[stateId] = ItemSet();
+            gotoKernels(closed, scratch);
+            for (int symbol : scratch.symbols) {
+                mergeInto(transitions.at({stateId, symbol}), scratch.kernel(symbol));
             }
+            continue;
+        }
+
+        expanded[stateId] = true;
+        gotoKernels(itemSets[stateId], scratch);
+        for (int symbol : scratch.symbols) {
+            const ItemSet& kernel = scratch.kernel(symbol);
+            stats.kernelLookups++;
+            int targetStateId = findState(kernel);
+            if (targetStateId >= 0) {
+                stats.kernelHits++;
+                mergeInto(targetStateId, kernel);
+            } else {
+                targetStateId = addState(ItemSet(kernel));
+            }
+
+            // Record the transition
+            transitions[{stateId, symbol}] = targetStateId;
         }
-        
-        itemSets = currentItemSets;
     }
+
+    stats.states = itemSets.size();
+    stats.transitions = transitions.size();
+    for (size_t state = 0; state < itemSets.size(); ++state) {
+        stats.bytes += itemSets[state].byteSize() + kernels[state].byteSize();
+    }
+    stats.scratchBytes += scratch.bytes;
+    stats.scratchGrowingCalls += scratch.growingCalls;
+    stats.peakRssKb = MemoryStats::peakRssKb();
+    stats.milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+}
+
+// Initial state: the augmented start rule with the dot in front, on "$"
+ItemSet ItemSetGenerator::startKernel() const {
+    int startProduction = grammar->rulesOf(nonTerminalIndex(grammar->augmentedStart())).first;
+    Bitset lookaheads(symbols.terminalCount());
+    lookaheads.set(SymbolTable::endMarker);
+    ItemSet kernel(symbols.terminalCount());
+    kernel.add(static_cast<uint32_t>(startProduction), 0, lookaheads);
+    kernel.finish();
+    return kernel;
 }
 
-const std::vector<std::set<Item>>& ItemSetGenerator::getItemSets() const {
+// Level-synchronous parallel construction of the canonical collection.
+// Workers expand one breadth-first frontier at a time: they compute the GOTO
+// kernels of their states, dedup them through a sharded concurrent index and
+// close the kernels they are first to claim. State IDs are then assigned
+// sequentially, walking the frontier in state order and each state's
+// successors in symbol order, which reproduces the sequential numbering
+// for any thread count.
+void ItemSetGenerator::generateCanonicalParallel(ItemSet&& startKernel, unsigned threads) {
+    struct Candidate {
+        ItemSet kernel;
+        ItemSet items;
+        int id = -1;
+    };
+    struct KernelPtrHash {
+        size_t operator()(const ItemSet* kernel) const { return static_cast<size_t>(kernel->fingerprint()); }
+    };
+    struct KernelPtrEqual {
+        bool operator()(const ItemSet* a, const ItemSet* b) const { return *a == *b; }
+    };
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<const ItemSet*, Candidate*, KernelPtrHash, KernelPtrEqual> index;
+    };
+
+    ThreadPool pool(threads);
+    std::vector<Shard> shards(threads * 16);
+    std::vector<std::deque<Candidate>> storage(threads);  // per worker; deque keeps addresses stable
+    std::vector<Scratch> scratch(threads, Scratch(*this));   // per worker
+    std::vector<size_t> closures(threads, 0);
+    std::vector<size_t> reused(threads, 0);
+    std::vector<Candidate*> candidates;                   // by state ID
+
+    auto claim = [&](const ItemSet& kernel, unsigned worker, bool& claimed) {
+        Shard& shard = shards[kernel.fingerprint() % shards.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto existing = shard.index.find(&kernel);
+        if (existing != shard.index.end()) return existing->second;
+
+        storage[worker].emplace_back();
+        Candidate* candidate = &storage[worker].back();
+        candidate->kernel = kernel;
+        shard.index.emplace(&candidate->kernel, candidate);
+        claimed = true;
+        return candidate;
+    };
+
+    bool claimed = false;
+    Candidate* start = claim(startKernel, 0, claimed);
+    start->id = 0;
+    itemSets.push_back(closeKernel(start->kernel, scratch[0], stats.closures, stats.reusedClosures));
+    candidates.push_back(start);
+
+    size_t frontierBegin = 0;
+    while (frontierBegin < itemSets.size()) {
+        size_t frontierEnd = itemSets.size();
+        std::vector<std::vector<std::pair<int, Candidate*>>> successors(frontierEnd - frontierBegin);
+
+        pool.parallelFor(frontierEnd - frontierBegin, [&](size_t i, unsigned worker) {
+            gotoKernels(itemSets[frontierBegin + i], scratch[worker]);
+            for (int symbol : scratch[worker].symbols) {
+                bool isNew = false;
+                Candidate* candidate = claim(scratch[worker].kernel(symbol), worker, isNew);
+                if (isNew) {
+                    candidate->items = closeKernel(candidate->kernel, scratch[worker], closures[worker], reused[worker]);
+                }
+                successors[i].emplace_back(symbol, candidate);
+            }
+        });
+
+        for (size_t i = 0; i < successors.size(); ++i) {
+            int stateId = static_cast<int>(frontierBegin + i);
+            for (auto& successor : successors[i]) {
+                Candidate* candidate = successor.second;
+                stats.kernelLookups++;
+                if (candidate->id < 0) {
+                    candidate->id = static_cast<int>(itemSets.size());
+                    itemSets.push_back(std::move(candidate->items));
+                    candidates.push_back(candidate);
+                } else {
+                    stats.kernelHits++;
+                }
+                transitions[{stateId, successor.first}] = candidate->id;
+            }
+        }
+        frontierBegin = frontierEnd;
+    }
+
+    for (Candidate* candidate : candidates) {
+        kernels.push_back(std::move(candidate->kernel));
+    }
+    for (unsigned worker = 0; worker < threads; ++worker) {
+        stats.closures += closures[worker];
+        stats.reusedClosures += reused[worker];
+        stats.scratchBytes += scratch[worker].bytes;
+        stats.scratchGrowingCalls += scratch[worker].growingCalls;
+    }
+    stats.threads = threads;
+}
+
+const std::vector<ItemSet>& ItemSetGenerator::getItemSets() const {
     return itemSets;
 }
 
-const std::map<std::pair<int, std::string>, int>& ItemSetGenerator::getTransitions() const {
+const std::vector<ItemSet>& ItemSetGenerator::getKernels() const {
+    return kernels;
+}
+
+const std::map<std::pair<int, int>, int>& ItemSetGenerator::getTransitions() const {
     return transitions;
 }
 
-std::set<Item> ItemSetGenerator::closure(const std::set<Item>& items) {
-    std::set<Item> closureSet = items;
-    bool changed = true;
-
-    while (changed) {
-        changed = false;
-        std::set<Item> newItems;
-        
-        for (const auto& item : closureSet) {
-            if (item.dot < item.rhs.size()) {
-                const std::string& nextSymbol = item.rhs[item.dot];
-                
-                if (productions.find(nextSymbol) != productions.end()) {
-                    // Get remaining symbols after the dot
-                    std::vector<std::string> remainingSymbols(
-                        item.rhs.begin() + item.dot + 1,
-                        item.rhs.end()
-                    );
-                    remainingSymbols.push_back(item.lookahead);
-
-                    // Compute FIRST set of remaining symbols
-                    std::set<std::string> firstRemaining;
-                    for (const auto& sym : remainingSymbols) {
-                        if (productions.find(sym) == productions.end()) {
-                            // Terminal symbol
-                            firstRemaining.insert(sym);
-                            break;
-                        } else {
-                            // Non-terminal symbol
-                            firstRemaining.insert(
-                                first.at(sym).begin(),
-                                first.at(sym).end()
-                            );
-                            if (first.at(sym).find("ε") == first.at(sym).end()) {
-                                break;
-                            }
-                        }
-                    }
+const SharedGrammar& ItemSetGenerator::getGrammar() const {
+    return grammar;
+}
 
-                    // Add new items for each production of the next symbol
-                    for (const auto& production : productions.at(nextSymbol)) {
-                        for (const auto& lookahead : firstRemaining) {
-                            Item newItem = {
-                                nextSymbol,
-                                production,
-                                0,  // Dot at beginning
-                                lookahead
-                            };
-                            
-                            if (closureSet.find(newItem) == closureSet.end()) {
-                                newItems.insert(newItem);
-                                changed = true;
-                            }
-                        }
-                    }
+const std::vector<Production>& ItemSetGenerator::getProductions() const {
+    return productions;
+}
+
+const SymbolTable& ItemSetGenerator::getSymbols() const {
+    return symbols;
+}
+
+const ItemSetStats& ItemSetGenerator::getStats() const {
+    return stats;
+}
+
+void ItemSetGenerator::reuseClosures(const ItemSetGenerator& previous, const GrammarDiff& diff) {
+    reusable.clear();
+
+    // A closure item reads the grammar only through the non-terminal at its
+    // dot, whose rules closure() adds, and the FIRST sets of the symbols after
+    // it up to the first non-nullable one, which give the added items'
+    // lookaheads. If neither changed for any item, neither did the closure.
+    const int previousNonTerminals = previous.symbols.nonTerminalCount();
+    std::vector<bool> rulesChanged(previousNonTerminals, true);
+    std::vector<bool> firstChanged(previousNonTerminals, true);
+    for (int old = 0; old < previousNonTerminals; ++old) {
+        int n = diff.nonTerminal(old);
+        if (n < 0) continue;
+        rulesChanged[old] = diff.changed(n);
+        firstChanged[old] = previous.nullable[old] != nullable[n] ||
+                            diff.remap(previous.first[old]) != first[n];
+    }
+
+    auto unaffected = [&](const Item& item) {
+        const std::vector<int>& rhs = previous.productions[item.production].rhs;
+        if (item.dot >= rhs.size() || previous.symbols.isTerminal(rhs[item.dot])) return true;
+        if (rulesChanged[previous.nonTerminalIndex(rhs[item.dot])]) return false;
+        for (size_t pos = item.dot + 1; pos < rhs.size() && !previous.symbols.isTerminal(rhs[pos]); ++pos) {
+            int old = previous.nonTerminalIndex(rhs[pos]);
+            if (firstChanged[old]) return false;
+            if (!previous.nullable[old]) break;
+        }
+        return true;
+    };
+
+    auto translate = [&](const ItemSet& oldItems, ItemSet& items) {
+        Bitset lookaheads(symbols.terminalCount());
+        for (const Item& item : oldItems) {
+            int production = diff.production(item.production);
+            if (production < 0 || !unaffected(item)) return false;
+            bool mapped = true;
+            lookaheads.clear();
+            item.forEachLookahead([&](size_t terminal) {
+                int lookahead = diff.terminal(static_cast<int>(terminal));
+                if (lookahead < 0) {
+                    mapped = false;
+                } else {
+                    lookaheads.set(lookahead);
                 }
+            });
+            if (!mapped) return false;
+            items.add(static_cast<uint32_t>(production), item.dot, lookaheads);
+        }
+        items.finish();   // renumbered rules may sort differently
+        return true;
+    };
+
+    for (size_t state = 0; state < previous.itemSets.size(); ++state) {
+        ItemSet kernel(symbols.terminalCount());
+        ItemSet items(symbols.terminalCount());
+        if (translate(previous.itemSets[state], items) && translate(previous.kernels[state], kernel)) {
+            reusable.emplace(std::move(kernel), std::move(items));
+        }
+    }
+}
+
+ItemSetGenerator::Scratch::Scratch(const ItemSetGenerator& generator)
+    : lookaheads(static_cast<size_t>(generator.symbols.nonTerminalCount()) *
+                 ((generator.symbols.terminalCount() + 63) / 64), 0),
+      marked(generator.symbols.nonTerminalCount(), 0),
+      merged((generator.symbols.terminalCount() + 63) / 64),
+      closed(generator.symbols.terminalCount()),
+      slotOf(generator.symbols.terminalCount() + generator.symbols.nonTerminalCount(), -1) {}
+
+// Buffers only grow (they are cleared, never shrunk), so a larger capacity
+// than after the previous call means some of them were reallocated
+void ItemSetGenerator::Scratch::noteGrowth() {
+    size_t now = lookaheads.capacity() * sizeof(uint64_t) + marked.capacity() +
+                 reached.capacity() * sizeof(int) + merged.capacity() * sizeof(uint64_t) +
+                 closed.byteSize() + slotOf.capacity() * sizeof(int) +
+                 symbols.capacity() * sizeof(int) + kernels.capacity() * sizeof(ItemSet);
+    for (const ItemSet& slot : kernels) {
+        now += slot.byteSize();
+    }
+    if (now > bytes) {
+        bytes = now;
+        growingCalls++;
+    }
+}
+
+ItemSet ItemSetGenerator::closeState(const ItemSet& kernel) const {
+    Scratch scratch(*this);
+    return closure(kernel, scratch);
+}
+
+std::map<int, ItemSet> ItemSetGenerator::successors(const ItemSet& items) const {
+    Scratch scratch(*this);
+    gotoKernels(items, scratch);
+    std::map<int, ItemSet> kernelsBySymbol;
+    for (int symbol : scratch.symbols) {
+        kernelsBySymbol.emplace(symbol, scratch.kernel(symbol));
+    }
+    return kernelsBySymbol;
+}
+
+// closure() of a state's kernel, unless reuseClosures() already has it,
+// copied out of the scratch buffers at its exact size
+ItemSet ItemSetGenerator::closeKernel(const ItemSet& kernel, Scratch& scratch, size_t& closures, size_t& reused) const {
+    auto found = reusable.find(kernel);
+    if (found != reusable.end()) {
+        reused++;
+        return found->second;
+    }
+    closures++;
+    return closure(kernel, scratch);
+}
+
+// The result lives in `scratch` until the next call
+const ItemSet& ItemSetGenerator::closure(const ItemSet& items, Scratch& scratch) const {
+    const size_t words = (symbols.terminalCount() + 63) / 64;
+    auto unite = [words](uint64_t* into, const uint64_t* from) {
+        for (size_t w = 0; w < words; ++w) into[w] |= from[w];
+    };
+
+    // Lookaheads for the rules of each non-terminal the kernel reaches
+    for (const auto& item : items) {
+        const std::vector<int>& rhs = productions[item.production].rhs;
+        if (item.dot >= rhs.size() || symbols.isTerminal(rhs[item.dot])) continue;
+
+        // The item's lookaheads for what it adds: FIRST of the symbols after
+        // the dot, then its own lookaheads if they are all nullable
+        size_t tail = tailOffset[item.production] + item.dot;
+        if (!tailNullable[tail] && tailFirst[tail].empty()) continue;
+
+        for (const ClosureEntry& entry : closureTemplates[nonTerminalIndex(rhs[item.dot])]) {
+            uint64_t* row = &scratch.lookaheads[entry.nonTerminal * words];
+            if (!scratch.marked[entry.nonTerminal]) {
+                scratch.marked[entry.nonTerminal] = 1;
+                scratch.reached.push_back(entry.nonTerminal);
+            }
+            unite(row, entry.spontaneous.data());
+            if (entry.propagates) {
+                unite(row, tailFirst[tail].data());
+                if (tailNullable[tail]) {
+                    unite(row, item.lookaheads);
+                }
+            }
+        }
+    }
+
+    // One item per rule of each non-terminal reached, carrying all of its
+    // lookaheads, merged in core order with the kernel. Rules are numbered
+    // non-terminal by non-terminal (see Grammar), so sorting the non-terminals
+    // orders the new items. Only a kernel item with the dot in front (the
+    // start state's) can share a core with them.
+    std::sort(scratch.reached.begin(), scratch.reached.end());
+    ItemSet& closed = scratch.closed;
+    closed.clear();
+    size_t next = 0;
+    for (int nonTerminal : scratch.reached) {
+        const uint64_t* row = &scratch.lookaheads[nonTerminal * words];
+        for (int production : grammar->rulesOf(nonTerminal)) {
+            uint64_t core = static_cast<uint64_t>(production) << 32;
+            for (; next < items.size() && items[next].core() < core; ++next) {
+                closed.add(items[next].production, items[next].dot, items[next].lookaheads);
+            }
+            if (next < items.size() && items[next].core() == core) {
+                std::copy(row, row + words, scratch.merged.begin());
+                unite(scratch.merged.data(), items[next++].lookaheads);
+                closed.add(static_cast<uint32_t>(production), 0, scratch.merged.data());
+            } else {
+                closed.add(static_cast<uint32_t>(production), 0, row);
             }
         }
-        
-        closureSet.insert(newItems.begin(), newItems.end());
+        std::fill(scratch.lookaheads.begin() + nonTerminal * words,
+                  scratch.lookaheads.begin() + (nonTerminal + 1) * words, 0);
+        scratch.marked[nonTerminal] = 0;
     }
-    
-    return closureSet;
+    for (; next < items.size(); ++next) {
+        closed.add(items[next].production, items[next].dot, items[next].lookaheads);
+    }
+    scratch.reached.clear();
+    closed.finish();
+    scratch.noteGrowth();
+    return closed;
 }
-std::set<Item> ItemSetGenerator::gotoFunction(const std::set<Item>& items, const std::string& symbol) {
-    std::set<Item> movedItems;
-    
+
+// Advances the dot over every symbol at once, grouping the moved items into
+// the GOTO kernel for each symbol. One pass over the state replaces a
+// gotoFunction() call per grammar symbol. The kernels are left in
+// `scratch` for scratch.symbols, in symbol order, until the next call.
+void ItemSetGenerator::gotoKernels(const ItemSet& items, Scratch& scratch) const {
+    for (int symbol : scratch.symbols) {
+        scratch.slotOf[symbol] = -1;
+    }
+    scratch.symbols.clear();
+
+    // Moving the dot keeps the core order, so each kernel comes out sorted
     for (const auto& item : items) {
-        if (item.dot < item.rhs.size() && item.rhs[item.dot] == symbol) {
-            Item movedItem = item;
-            movedItem.dot++;
-            movedItems.insert(movedItem);
+        const std::vector<int>& rhs = productions[item.production].rhs;
+        if (item.dot >= rhs.size()) continue;
+        int& slot = scratch.slotOf[rhs[item.dot]];
+        if (slot < 0) {
+            slot = static_cast<int>(scratch.symbols.size());
+            scratch.symbols.push_back(rhs[item.dot]);
+            if (scratch.kernels.size() <= static_cast<size_t>(slot)) {
+                scratch.kernels.emplace_back(symbols.terminalCount());
+            } else {
+                scratch.kernels[slot].clear();
+            }
         }
+        scratch.kernels[slot].add(item.production, item.dot + 1, item.lookaheads);
+    }
+    for (int symbol : scratch.symbols) {
+        scratch.kernels[scratch.slotOf[symbol]].finish();
+    }
+    std::sort(scratch.symbols.begin(), scratch.symbols.end());
+    scratch.noteGrowth();
+}
+
+// The kernel's (production, dot) pairs, in item order
+std::vector<uint64_t> ItemSetGenerator::coreOf(const ItemSet& kernel) {
+    std::vector<uint64_t> core;
+    core.reserve(kernel.size());
+    for (const auto& item : kernel) {
+        core.push_back(item.core());
     }
-    
-    return closure(movedItems);
+    return core;
+}
+
+// Pager's weak compatibility: merging two same-core kernels cannot create a
+// reduce/reduce conflict (here or in any successor) unless, for some pair of
+// items i != j, lookaheads cross between the states while neither state
+// already has i and j sharing a lookahead.
+bool ItemSetGenerator::weaklyCompatible(const ItemSet& a, const ItemSet& b) const {
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = i + 1; j < a.size(); ++j) {
+            bool crossFree = !a[i].intersects(b[j]) && !b[i].intersects(a[j]);
+            if (!crossFree && !a[i].intersects(a[j]) && !b[i].intersects(b[j])) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
 void ItemSetGenerator::displayItemSets(std::ostream& os) const {
     for (size_t stateId = 0; stateId < itemSets.size(); ++stateId) {
-        std::cout << "I" << stateId << ":\n";
+        os << "I" << stateId << ":\n";
         for (const auto& item : itemSets[stateId]) {
-            std::cout << item.lhs << " -> ";
-            
+            const Production& production = productions[item.production];
+            os << symbols.name(production.lhs) << " -> ";
+
             // Print production with dot
-            for (size_t pos = 0; pos < item.rhs.size(); ++pos) {
-                if (pos == item.dot) std::cout << ". ";
-                std::cout << item.rhs[pos] << " ";
+            for (size_t pos = 0; pos < production.rhs.size(); ++pos) {
+                if (pos == item.dot) os << ". ";
+                os << symbols.name(production.rhs[pos]) << " ";
             }
-            
+
             // Handle dot at end case
-            if (item.dot == item.rhs.size()) std::cout << ". ";
-            
-            std::cout << ", " << item.lookahead << "\n";
+            if (item.dot == production.rhs.size()) os << ". ";
+
+            // All of the item's lookaheads, space-separated like the symbols
+            os << ",";
+            item.forEachLookahead([&](size_t lookahead) {
+                os << " " << symbols.name(static_cast<int>(lookahead));
+            });
+            os << "\n";
         }
-        std::cout << "\n";
+        os << "\n";
     }
 }
@@ -1,37 +1,137 @@
 //ItemSetGenerator.h
 #pragma once
+#include "Bitset.h"
+#include "Grammar.h"
+#include "GrammarDiff.h"
+#include "ItemSet.h"
+#include <cstdint>
 #include <string>
 #include <vector>
-#include <set>
 #include <map>
-#include <tuple>
+#include <unordered_map>
 
-struct Item {
-    std::string lhs;
-    std::vector<std::string> rhs;
-    size_t dot;
-    std::string lookahead;
+struct CoreHash {
+    size_t operator()(const std::vector<uint64_t>& core) const;
+};
+
+// How GOTO kernels that share a core with an existing state are handled:
+// CanonicalLR1 never merges, LALR1 always merges, and MinimalLR1 merges only
+// when Pager's weak compatibility test shows no new conflict can arise.
+enum class ConstructionMode { CanonicalLR1, LALR1, MinimalLR1 };
+const char* constructionModeName(ConstructionMode mode);
 
-    bool operator<(const Item& other) const;
-    bool operator==(const Item& other) const;
+// Counters collected by generateItemSets() to check that construction scales
+// with the number of states rather than its square.
+struct ItemSetStats {
+    size_t states = 0;
+    size_t transitions = 0;
+    size_t closures = 0;          // closure() calls: one per state, plus one per merge
+    size_t kernelLookups = 0;     // GOTO kernels looked up in the state index
+    size_t kernelHits = 0;        // ...of which matched an existing state
+    size_t merges = 0;            // lookahead merges that grew a state
+    size_t reusedClosures = 0;    // closures carried over by reuseClosures()
+    size_t bytes = 0;             // item sets and kernels as stored
+    size_t scratchBytes = 0;      // scratch buffers at their largest, all threads
+    // closure()/GOTO calls after which the scratch buffers were larger. Not an
+    // allocation count: one such call may have reallocated several buffers,
+    // and item sets as stored are allocated besides.
+    size_t scratchGrowingCalls = 0;
+    size_t peakRssKb = 0;         // process peak RSS after the build (see MemoryStats.h)
+    unsigned threads = 1;
+    double milliseconds = 0.0;
 };
 
 class ItemSetGenerator {
 public:
-    ItemSetGenerator(const std::map<std::string, std::vector<std::vector<std::string>>>& prod,
-                     const std::map<std::string, std::set<std::string>>& first);
+    ItemSetGenerator(SharedGrammar grammar,
+                     const std::vector<Bitset>& first,
+                     const std::vector<bool>& nullable);
+
+    void setConstructionMode(ConstructionMode mode);
+    ConstructionMode getConstructionMode() const;
+    // Worker threads for canonical LR(1) construction (0 = all cores).
+    // Merging modes are order dependent and always build sequentially.
+    void setThreadCount(unsigned threads);
+    // Incremental regeneration: closures of `previous` (built for the grammar
+    // before `diff`) whose items never reach a non-terminal with changed rules,
+    // FIRST or nullable are renumbered and reused instead of recomputed.
+    // Call before generateItemSets().
+    void reuseClosures(const ItemSetGenerator& previous, const GrammarDiff& diff);
 
     void generateItemSets();
+
+    // Building blocks for on-demand construction (see LazyAutomaton.h): the
+    // start state's kernel, a kernel's closure, and a closed state's GOTO
+    // kernels by symbol. They only read the grammar, so any number of
+    // threads may call them at once.
+    ItemSet startKernel() const;
+    ItemSet closeState(const ItemSet& kernel) const;
+    std::map<int, ItemSet> successors(const ItemSet& items) const;
     void displayItemSets(std::ostream& os) const;
-    const std::vector<std::set<Item>>& getItemSets() const;
-    const std::map<std::pair<int, std::string>, int>& getTransitions() const;
+    const std::vector<ItemSet>& getItemSets() const;
+    const std::vector<ItemSet>& getKernels() const;   // by state, as closed
+    const std::map<std::pair<int, int>, int>& getTransitions() const;
+    const SharedGrammar& getGrammar() const;
+    const std::vector<Production>& getProductions() const;
+    const SymbolTable& getSymbols() const;
+    const ItemSetStats& getStats() const;
 
 private:
-    std::map<std::string, std::vector<std::vector<std::string>>> productions;
-    std::map<std::string, std::set<std::string>> first;
-    std::vector<std::set<Item>> itemSets;
-    std::map<std::pair<int, std::string>, int> transitions;
+    SharedGrammar grammar;
+    const SymbolTable& symbols;                    // ...of `grammar`
+    const std::vector<Production>& productions;
+    std::vector<Bitset> first;                     // by non-terminal index
+    std::vector<bool> nullable;                    // by non-terminal index
+    ConstructionMode mode;
+    unsigned threadCount;
+    std::vector<ItemSet> kernels;
+    std::vector<ItemSet> itemSets;
+    std::map<std::pair<int, int>, int> transitions;
+    ItemSetStats stats;
+    std::unordered_map<ItemSet, ItemSet, ItemSetHash> reusable;   // kernel -> closure
+
+    // Closure templates, built once from the grammar. An item with the dot
+    // before A, whose lookaheads are FIRST of what follows A, adds the rules
+    // of every non-terminal B that A reaches through the leftmost symbols
+    // of its rules. B's lookaheads are `spontaneous` (FIRST of rule tails
+    // on the way from A), plus the item's own if `propagates` (all those
+    // tails nullable).
+    struct ClosureEntry {
+        int nonTerminal;
+        bool propagates;
+        Bitset spontaneous;
+    };
+    std::vector<std::vector<ClosureEntry>> closureTemplates;   // by non-terminal index
+    std::vector<size_t> tailOffset;      // by production, into the two below
+    std::vector<Bitset> tailFirst;       // FIRST of the rhs after each position
+    std::vector<bool> tailNullable;      // ...and whether it derives ε
+
+    // Buffers one thread reuses from state to state, so that closing a state
+    // and collecting its GOTO kernels allocate only while they still grow.
+    // States that are kept are copied out once, at their exact size.
+    struct Scratch {
+        explicit Scratch(const ItemSetGenerator& generator);
+        std::vector<uint64_t> lookaheads;   // closure: a bitset row per non-terminal
+        std::vector<char> marked;           // ...rows in use
+        std::vector<int> reached;           // ...their non-terminals
+        std::vector<uint64_t> merged;       // ...a rule's row joined with a kernel item's
+        ItemSet closed;                     // ...the result
+        std::vector<int> slotOf;            // GOTO: by symbol, into kernels; -1 = none
+        std::vector<int> symbols;           // ...symbols with a kernel, ascending
+        std::vector<ItemSet> kernels;       // ...by slot
+        size_t bytes = 0;                   // capacity of all of the above so far
+        size_t growingCalls = 0;            // calls after which it had grown
+
+        const ItemSet& kernel(int symbol) const { return kernels[slotOf[symbol]]; }
+        void noteGrowth();
+    };
 
-    std::set<Item> closure(const std::set<Item>& items);
-    std::set<Item> gotoFunction(const std::set<Item>& items, const std::string& symbol);
+    int nonTerminalIndex(int symbol) const { return symbol - symbols.terminalCount(); }
+    void buildClosureTemplates();
+    const ItemSet& closure(const ItemSet& items, Scratch& scratch) const;
+    ItemSet closeKernel(const ItemSet& kernel, Scratch& scratch, size_t& closures, size_t& reused) const;
+    void generateCanonicalParallel(ItemSet&& startKernel, unsigned threads);
+    void gotoKernels(const ItemSet& items, Scratch& scratch) const;
+    static std::vector<uint64_t> coreOf(const ItemSet& kernel);
+    bool weaklyCompatible(const ItemSet& a, const ItemSet& b) const;
 };
@@ -0,0 +1,111 @@
+// LRDriver.h
+#pragma once
+#include "ParseTable.h"
+#include "SymbolTable.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Receives the driver's shifts, reductions and acceptance, e.g. to build a
+// tree (see SyntaxTree.h).
+// Symbols are IDs; `position` is the index of the next unread token.
+struct NoParseListener {
+    void shift(int /*terminal*/, size_t /*position*/) {}
+    void reduce(int /*rule*/, int /*lhs*/, int /*length*/, size_t /*position*/) {}
+    void accept() {}
+};
+
+// The LR driver loop shared by every table layout. Table must provide
+// action(state, terminal), gotoState(state, nonTerminal), terminalCount(),
+// stateCount() and rule(rule), the ParseTable::Rule for a rule number.
+// Tokens are terminal IDs; the end marker is implied after the last one and
+// negative IDs are unknown tokens.
+//
+// Tables with conflicts resolved by precedence (see ParseTable::setAction)
+// can reduce forever without reading a token, e.g. for a cyclic grammar or
+// around ε rules. The input is then rejected at that token as soon as the
+// reductions since the last shift provably repeat: when the stack has grown
+// more levels above its lowest point than there are states (some state then
+// sits on two levels with nothing below the lower one disturbed, and
+// everything between repeats), or when the stack comes back to an earlier
+// configuration, which is checked Brent-style once a run of reductions
+// without a new lowest point gets long.
+template <typename Table, typename Listener>
+ParseTable::Result runLRParser(const Table& table, const std::vector<int>& tokens, std::vector<int>& stack,
+                               Listener& listener) {
+    ParseTable::Result result;
+    stack.clear();
+    stack.push_back(0);
+    size_t position = 0;
+    const int terminals = table.terminalCount();
+
+    const size_t firstSnapshot = 64;
+    size_t floor = stack.size();           // lowest stack since the last shift
+    size_t reductions = 0;                 // ...and reductions since then
+    size_t nextSnapshot = firstSnapshot;
+    std::vector<int> snapshot;             // only filled by a long run of reductions
+
+    while (true) {
+        int terminal = position < tokens.size() ? tokens[position] : SymbolTable::endMarker;
+        ParseTable::Action next = (terminal >= 0 && terminal < terminals)
+            ? table.action(stack.back(), terminal)
+            : ParseTable::makeAction(ParseTable::Error, 0);
+        result.actions++;
+
+        switch (ParseTable::kind(next)) {
+        case ParseTable::Shift:
+            stack.push_back(ParseTable::value(next));
+            listener.shift(terminal, position);
+            position++;
+            floor = stack.size();
+            reductions = 0;
+            nextSnapshot = firstSnapshot;
+            break;
+        case ParseTable::Reduce: {
+            int number = ParseTable::value(next);
+            const ParseTable::Rule& rule = table.rule(number);
+            stack.resize(stack.size() - rule.length);
+            stack.push_back(table.gotoState(stack.back(), rule.lhs));
+            listener.reduce(number, terminals + rule.lhs, rule.length, position);
+
+            bool looping = false;
+            if (stack.size() < floor) {
+                // The stack can only sink so far, so start over from here
+                floor = stack.size();
+                reductions = 0;
+                nextSnapshot = firstSnapshot;
+            } else {
+                looping = stack.size() - floor > static_cast<size_t>(table.stateCount());
+            }
+            if (++reductions >= firstSnapshot) {
+                // Below the top of the lowest stack nothing has changed since
+                const auto from = stack.begin() + (floor - 1);
+                if (reductions == nextSnapshot) {
+                    snapshot.assign(from, stack.end());
+                    nextSnapshot *= 2;
+                } else {
+                    looping |= std::equal(from, stack.end(), snapshot.begin(), snapshot.end());
+                }
+            }
+            if (looping) {
+                result.errorPosition = position;
+                return result;
+            }
+            break;
+        }
+        case ParseTable::Accept:
+            result.accepted = true;
+            listener.accept();
+            return result;
+        default:
+            result.errorPosition = position;
+            return result;
+        }
+    }
+}
+
+template <typename Table>
+ParseTable::Result runLRParser(const Table& table, const std::vector<int>& tokens, std::vector<int>& stack) {
+    NoParseListener listener;
+    return runLRParser(table, tokens, stack, listener);
+}
@@ -0,0 +1,93 @@
+// LazyAutomaton.cpp
+#include "LazyAutomaton.h"
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+LazyAutomaton::LazyAutomaton(ItemSetGenerator generator, const ParseTableView& rules)
+    : generator(std::move(generator)),
+      terminals(this->generator.getSymbols().terminalCount()),
+      nonTerminals(this->generator.getSymbols().nonTerminalCount()),
+      augmentedStart(this->generator.getGrammar()->augmentedStart()),
+      rules(rules),
+      chunks(new std::atomic<State*>[maxChunks]()),
+      shards(new Shard[shardCount]) {
+    intern(this->generator.startKernel());   // state 0
+}
+
+LazyAutomaton::~LazyAutomaton() {
+    for (size_t chunk = 0; chunk < maxChunks; ++chunk) {
+        delete[] chunks[chunk].load(std::memory_order_relaxed);
+    }
+}
+
+// State number of a kernel, adding the state (unexpanded) if it is new
+int LazyAutomaton::intern(ItemSet&& kernel) const {
+    Shard& shard = shards[ItemSetHash()(kernel) % shardCount];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.states.find(kernel);
+    if (found != shard.states.end()) {
+        return found->second;
+    }
+
+    size_t id = nextState.fetch_add(1, std::memory_order_relaxed);
+    if (id >= chunkSize * maxChunks) {
+        throw std::runtime_error("Lazy automaton exceeded " + std::to_string(chunkSize * maxChunks) + " states");
+    }
+    std::atomic<State*>& slot = chunks[id / chunkSize];
+    State* chunk = slot.load(std::memory_order_acquire);
+    if (!chunk) {
+        // Threads in other shards may need the same chunk; one allocation wins
+        State* fresh = new State[chunkSize];
+        if (slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel)) {
+            chunk = fresh;
+        } else {
+            delete[] fresh;
+        }
+    }
+
+    auto inserted = shard.states.emplace(std::move(kernel), static_cast<int>(id)).first;
+    chunk[id % chunkSize].kernel = &inserted->first;
+    return static_cast<int>(id);
+}
+
+// Builds a state's ACTION and GOTO rows, as CanonicalLRParser::buildParseTable
+// does for every state of an eager build
+void LazyAutomaton::expand(State& state) const {
+    std::call_once(state.once, [this, &state] {
+        ItemSet items = generator.closeState(*state.kernel);
+        const std::vector<Production>& productions = generator.getProductions();
+
+        std::vector<ParseTable::Action> actions(terminals, ParseTable::makeAction(ParseTable::Error, 0));
+        std::vector<int> gotos(nonTerminals, -1);
+        size_t found = 0;
+        for (auto& successor : generator.successors(items)) {
+            int target = intern(std::move(successor.second));
+            if (successor.first < terminals) {
+                found += !ParseTable::resolve(actions[successor.first],
+                                              ParseTable::makeAction(ParseTable::Shift, target));
+            } else {
+                gotos[successor.first - terminals] = target;
+            }
+        }
+        for (const auto& item : items) {
+            const Production& production = productions[item.production];
+            if (item.dot < production.rhs.size()) continue;
+            if (production.lhs == augmentedStart) {
+                found += !ParseTable::resolve(actions[SymbolTable::endMarker],
+                                              ParseTable::makeAction(ParseTable::Accept, 0));
+            } else {
+                item.forEachLookahead([&](size_t lookahead) {
+                    found += !ParseTable::resolve(actions[lookahead],
+                        ParseTable::makeAction(ParseTable::Reduce, static_cast<int>(item.production)));
+                });
+            }
+        }
+
+        state.actions = std::move(actions);
+        state.gotos = std::move(gotos);
+        conflicts.fetch_add(found, std::memory_order_relaxed);
+        expandedStates.fetch_add(1, std::memory_order_relaxed);
+        state.ready.store(true, std::memory_order_release);
+    });
+}
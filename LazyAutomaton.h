@@ -0,0 +1,102 @@
+// LazyAutomaton.h
+#pragma once
+#include "ItemSetGenerator.h"
+#include "LRDriver.h"
+#include "ParseTable.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Canonical LR(1) automaton built on demand. Only the start state exists at
+// first. A state's closure, successors and ACTION/GOTO rows are computed the
+// first time the driver reads one of its entries, and kept from then on, so
+// startup costs nothing and memory grows with the states the inputs
+// actually reach rather than the whole automaton.
+//
+// It has the table interface runLRParser() expects and is safe to share
+// between threads: expanding a state runs once under std::call_once, and
+// reads of an expanded state take no lock. New kernels are numbered through
+// a sharded, mutex-protected index. State numbers follow discovery order, so
+// they differ from an eager build's and between runs.
+class LazyAutomaton {
+public:
+    // `generator` must be set up for the grammar; its item sets need not
+    // have been generated. `rules` supplies the rule table, which must
+    // outlive the automaton (ParseTables owns both).
+    LazyAutomaton(ItemSetGenerator generator, const ParseTableView& rules);
+    ~LazyAutomaton();
+    LazyAutomaton(const LazyAutomaton&) = delete;
+    LazyAutomaton& operator=(const LazyAutomaton&) = delete;
+
+    ParseTable::Action action(int state, int terminal) const {
+        return expanded(state).actions[terminal];
+    }
+    int gotoState(int state, int nonTerminal) const {
+        return expanded(state).gotos[nonTerminal];
+    }
+    int terminalCount() const { return terminals; }
+    int nonTerminalCount() const { return nonTerminals; }
+    int ruleCount() const { return rules.ruleCount(); }
+    const ParseTable::Rule& rule(int rule) const { return rules.rule(rule); }
+    int ruleLhs(int rule) const { return rules.ruleLhs(rule); }
+    int ruleLength(int rule) const { return rules.ruleLength(rule); }
+
+    ParseTable::Result parse(const std::vector<int>& tokens, std::vector<int>& stack) const {
+        return runLRParser(*this, tokens, stack);
+    }
+
+    // States numbered so far, and of those, the ones whose rows are built
+    size_t stateCount() const { return nextState.load(std::memory_order_relaxed); }
+    size_t expandedCount() const { return expandedStates.load(std::memory_order_relaxed); }
+    // Conflicts resolved by precedence in the expanded states (see
+    // ParseTable::setAction)
+    size_t conflictCount() const { return conflicts.load(std::memory_order_relaxed); }
+
+private:
+    struct State {
+        const ItemSet* kernel = nullptr;   // key in its shard's index
+        std::once_flag once;
+        std::atomic<bool> ready{false};
+        std::vector<ParseTable::Action> actions;   // by terminal
+        std::vector<int> gotos;                    // by non-terminal, -1 = none
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<ItemSet, int, ItemSetHash> states;   // kernel -> state
+    };
+
+    static constexpr size_t chunkSize = 1024;
+    static constexpr size_t maxChunks = 65536;
+    static constexpr size_t shardCount = 64;
+
+    const ItemSetGenerator generator;
+    const int terminals;
+    const int nonTerminals;
+    const int augmentedStart;
+    const ParseTableView rules;   // no states, only the rule table
+
+    // States live in fixed-size chunks that are never moved, so a state
+    // number resolves without locking while others are being added
+    std::unique_ptr<std::atomic<State*>[]> chunks;
+    std::unique_ptr<Shard[]> shards;
+    mutable std::atomic<size_t> nextState{0};
+    mutable std::atomic<size_t> expandedStates{0};
+    mutable std::atomic<size_t> conflicts{0};
+
+    State& at(int state) const {
+        return chunks[state / chunkSize].load(std::memory_order_acquire)[state % chunkSize];
+    }
+    const State& expanded(int state) const {
+        State& entry = at(state);
+        if (!entry.ready.load(std::memory_order_acquire)) {
+            expand(entry);
+        }
+        return entry;
+    }
+    void expand(State& state) const;
+    int intern(ItemSet&& kernel) const;
+};
@@ -0,0 +1,8 @@
+// MemoryStats.h
+#pragma once
+#include <cstddef>
+
+// Process-wide memory figures for build statistics
+namespace MemoryStats {
+    size_t peakRssKb();     // peak resident set size so far; 0 where unknown
+}
@@ -0,0 +1,75 @@
+// ParseTable.cpp
+#include "ParseTable.h"
+#include "LRDriver.h"
+
+ParseTable::ParseTable(int states, int terminals, int nonTerminals)
+    : states(states), terminals(terminals), nonTerminals(nonTerminals),
+      actions(static_cast<size_t>(states) * terminals, makeAction(Error, 0)),
+      gotos(static_cast<size_t>(states) * nonTerminals, -1) {}
+
+std::string ParseTable::describe(Action action) {
+    switch (kind(action)) {
+    case Shift:
+        return "s" + std::to_string(value(action));
+    case Reduce:
+        return "r" + std::to_string(value(action));
+    case Accept:
+        return "acc";
+    default:
+        return "";
+    }
+}
+
+bool ParseTable::setAction(int state, int terminal, Action action) {
+    return resolve(actions[static_cast<size_t>(state) * terminals + terminal], action);
+}
+
+bool ParseTable::resolve(Action& entry, Action action) {
+    if (kind(entry) == Error || entry == action) {
+        entry = action;
+        return true;
+    }
+
+    // Conflict: accept wins, then shift, then the lowest-numbered rule
+    auto rank = [](Action a) { return kind(a) == Accept ? 0 : kind(a) == Shift ? 1 : 2; };
+    if (rank(action) < rank(entry) ||
+        (rank(action) == rank(entry) && value(action) < value(entry))) {
+        entry = action;
+    }
+    return false;
+}
+
+void ParseTable::setGoto(int state, int nonTerminal, int target) {
+    gotos[static_cast<size_t>(state) * nonTerminals + nonTerminal] = target;
+}
+
+void ParseTable::setRule(int rule, int lhs, int length) {
+    if (rule >= static_cast<int>(rules.size())) {
+        rules.resize(rule + 1, Rule{0, 0});
+    }
+    rules[rule] = Rule{lhs, length};
+}
+
+size_t ParseTable::byteSize() const {
+    return actions.size() * sizeof(Action) + gotos.size() * sizeof(int32_t) +
+           rules.size() * sizeof(Rule);
+}
+
+ParseTable::Result ParseTable::parse(const std::vector<int>& tokens, std::vector<int>& stack) const {
+    return runLRParser(*this, tokens, stack);
+}
+
+ParseTableView ParseTable::view() const {
+    return ParseTableView(states, terminals, nonTerminals, ruleCount(),
+                          actions.data(), gotos.data(), rules.data());
+}
+
+size_t ParseTableView::byteSize() const {
+    return static_cast<size_t>(states) * terminals * sizeof(ParseTable::Action) +
+           static_cast<size_t>(states) * nonTerminals * sizeof(int32_t) +
+           static_cast<size_t>(rules) * sizeof(ParseTable::Rule);
+}
+
+ParseTable::Result ParseTableView::parse(const std::vector<int>& tokens, std::vector<int>& stack) const {
+    return runLRParser(*this, tokens, stack);
+}
@@ -0,0 +1,117 @@
+// ParseTable.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compiled ACTION/GOTO tables: one contiguous row of ACTION words per state,
+// indexed by terminal ID, and one row of GOTO targets per state, indexed by
+// non-terminal index. An ACTION word keeps its kind in the top two bits and
+// the target state or rule number in the rest. A flat rule table indexed by
+// that rule number gives a reduction everything else it needs.
+class ParseTableView;
+
+class ParseTable {
+public:
+    typedef uint32_t Action;
+    enum Kind : uint32_t { Error = 0, Shift = 1, Reduce = 2, Accept = 3 };
+
+    static Action makeAction(Kind kind, int value) {
+        return (static_cast<uint32_t>(kind) << 30) | static_cast<uint32_t>(value);
+    }
+    static Kind kind(Action action) { return static_cast<Kind>(action >> 30); }
+    static int value(Action action) { return static_cast<int>(action & 0x3FFFFFFF); }
+    static std::string describe(Action action);  // "s12", "r3", "acc" or ""
+
+    // A rule as a reduction uses it: the left-hand side (non-terminal index)
+    // and the right-hand side length, side by side so one load fetches both
+    struct Rule {
+        int32_t lhs;
+        int32_t length;
+    };
+
+    // Result of parse(): errorPosition is the index of the offending token
+    // (tokens.size() for the end marker) when the input is rejected.
+    struct Result {
+        bool accepted = false;
+        size_t errorPosition = 0;
+        size_t actions = 0;
+    };
+
+    ParseTable() = default;
+    ParseTable(int states, int terminals, int nonTerminals);
+
+    Action action(int state, int terminal) const { return actions[static_cast<size_t>(state) * terminals + terminal]; }
+    int gotoState(int state, int nonTerminal) const { return gotos[static_cast<size_t>(state) * nonTerminals + nonTerminal]; }
+
+    // Returns false if the entry already held a different action. The
+    // conflict is then resolved by precedence, and the entry ends up holding
+    // the winner, old or new: accept beats shift, shift beats reduce, and
+    // between two reductions the lower-numbered rule wins.
+    bool setAction(int state, int terminal, Action action);
+    // The same for an entry kept elsewhere
+    static bool resolve(Action& entry, Action action);
+    void setGoto(int state, int nonTerminal, int target);
+    void setRule(int rule, int lhs, int length);
+
+    int stateCount() const { return states; }
+    int terminalCount() const { return terminals; }
+    int nonTerminalCount() const { return nonTerminals; }
+    int ruleCount() const { return static_cast<int>(rules.size()); }
+    const Rule& rule(int rule) const { return rules[rule]; }
+    int ruleLhs(int rule) const { return rules[rule].lhs; }
+    int ruleLength(int rule) const { return rules[rule].length; }
+    size_t byteSize() const;
+
+    // Table-driven parse of terminal IDs (the end marker is implied after the
+    // last token; negative IDs are unknown tokens). `stack` is scratch space
+    // the caller may reuse across calls.
+    Result parse(const std::vector<int>& tokens, std::vector<int>& stack) const;
+
+    // Read-only view of this table's arrays; valid while the table is alive
+    // and unmodified.
+    ParseTableView view() const;
+
+private:
+    int states = 0;
+    int terminals = 0;
+    int nonTerminals = 0;
+    std::vector<Action> actions;
+    std::vector<int32_t> gotos;          // -1 where no transition exists
+    std::vector<Rule> rules;             // by rule number
+};
+
+// The same lookups as ParseTable over arrays owned elsewhere: a ParseTable,
+// or a mapped table file (see TableFile.h) whose arrays are used in place.
+class ParseTableView {
+public:
+    ParseTableView() = default;
+    ParseTableView(int states, int terminals, int nonTerminals, int rules,
+                   const ParseTable::Action* actions, const int32_t* gotos, const ParseTable::Rule* ruleTable)
+        : states(states), terminals(terminals), nonTerminals(nonTerminals), rules(rules),
+          actions(actions), gotos(gotos), ruleTable(ruleTable) {}
+
+    ParseTable::Action action(int state, int terminal) const { return actions[static_cast<size_t>(state) * terminals + terminal]; }
+    int gotoState(int state, int nonTerminal) const { return gotos[static_cast<size_t>(state) * nonTerminals + nonTerminal]; }
+
+    int stateCount() const { return states; }
+    int terminalCount() const { return terminals; }
+    int nonTerminalCount() const { return nonTerminals; }
+    int ruleCount() const { return rules; }
+    const ParseTable::Rule& rule(int rule) const { return ruleTable[rule]; }
+    int ruleLhs(int rule) const { return ruleTable[rule].lhs; }
+    int ruleLength(int rule) const { return ruleTable[rule].length; }
+    size_t byteSize() const;
+
+    ParseTable::Result parse(const std::vector<int>& tokens, std::vector<int>& stack) const;
+
+private:
+    int states = 0;
+    int terminals = 0;
+    int nonTerminals = 0;
+    int rules = 0;
+    const ParseTable::Action* actions = nullptr;
+    const int32_t* gotos = nullptr;
+    const ParseTable::Rule* ruleTable = nullptr;
+};
@@ -0,0 +1,65 @@
+// ParseTables.cpp
+#include "ParseTables.h"
+#include <stdexcept>
+#include <utility>
+
+ParseTables::ParseTables(const SymbolTable& symbols, ParseTable table, bool compress, size_t conflicts,
+                         SharedGrammar grammar)
+    : symbolTable(symbols), sourceGrammar(std::move(grammar)), denseTable(std::move(table)), denseView(denseTable.view()),
+      compressed(compress), conflicts(conflicts) {
+    if (compressed) {
+        packedTable = CompressedParseTable(denseView);
+    }
+    indexTerminals();
+}
+
+ParseTables::ParseTables(const SymbolTable& symbols, std::unique_ptr<TableFile> mapped, bool compress)
+    : symbolTable(symbols), file(std::move(mapped)), denseView(file->view()),
+      compressed(compress), conflicts(file->conflictCount()) {
+    if (compressed) {
+        packedTable = CompressedParseTable(denseView);
+    }
+    indexTerminals();
+}
+
+SharedParseTables ParseTables::lazy(ItemSetGenerator generator) {
+    // An empty table carries the rules for table() users such as
+    // SemanticActions; the automaton reduces through the same rule table
+    const Grammar& grammar = *generator.getGrammar();
+    const SymbolTable& symbols = grammar.symbols();
+    ParseTable rules(0, symbols.terminalCount(), symbols.nonTerminalCount());
+    for (int rule = 0; rule < grammar.ruleCount(); ++rule) {
+        rules.setRule(rule, grammar.productions()[rule].lhs - symbols.terminalCount(), grammar.ruleLength(rule));
+    }
+    std::shared_ptr<ParseTables> tables(new ParseTables(symbols, std::move(rules), false, 0, generator.getGrammar()));
+    tables->automaton.reset(new LazyAutomaton(std::move(generator), tables->denseView));
+    return tables;
+}
+
+void ParseTables::indexTerminals() {
+    for (int terminal = 0; terminal < symbolTable.terminalCount(); ++terminal) {
+        terminalIds.emplace(symbolTable.name(terminal), terminal);
+    }
+}
+
+ParseTable::Result ParseTables::parse(const std::vector<int>& tokens, std::vector<int>& stack,
+                                      SyntaxTree& tree) const {
+    tree.clear();
+    return parse<SyntaxTree>(tokens, stack, tree);
+}
+
+void ParseTables::save(const std::string& path) const {
+    if (automaton) {
+        throw std::runtime_error("Lazily built parse tables cannot be saved");
+    }
+    TableFile::write(path, symbolTable, denseView, static_cast<uint32_t>(conflicts));
+}
+
+SharedParseTables ParseTables::load(const std::string& path, bool compress) {
+    std::unique_ptr<TableFile> mapped(new TableFile(path));
+    SymbolTable symbols = mapped->symbols();
+    if (!TableFile::inPlace()) {
+        return SharedParseTables(new ParseTables(symbols, mapped->decode(), compress, mapped->conflictCount()));
+    }
+    return SharedParseTables(new ParseTables(symbols, std::move(mapped), compress));
+}
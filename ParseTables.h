@@ -0,0 +1,90 @@
+// ParseTables.h
+#pragma once
+#include "CompressedParseTable.h"
+#include "ParseTable.h"
+#include "LazyAutomaton.h"
+#include "LRDriver.h"
+#include "SymbolTable.h"
+#include "SyntaxTree.h"
+#include "TableFile.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Everything a parser needs from table generation, frozen after
+// construction. Hold it through SharedParseTables: any number of threads can
+// parse against one instance concurrently, since nothing here is mutated
+// after the constructor returns and per-parse scratch lives in the caller.
+class ParseTables;
+typedef std::shared_ptr<const ParseTables> SharedParseTables;
+class ParseTables {
+public:
+    // Builds the compressed form as well when `compress` is set; parse()
+    // then runs on it. `conflicts` is what generating `table` resolved;
+    // `grammar`, if given, is the grammar it was generated from.
+    ParseTables(const SymbolTable& symbols, ParseTable table, bool compress, size_t conflicts = 0,
+                SharedGrammar grammar = SharedGrammar());
+    // Tables whose states are built as parsing reaches them (see
+    // LazyAutomaton.h). table() then has the rules but no states, and the
+    // conflict count covers the states built so far.
+    static SharedParseTables lazy(ItemSetGenerator generator);
+    ParseTables(const ParseTables&) = delete;
+    ParseTables& operator=(const ParseTables&) = delete;
+
+    // Writes the symbol, rule and ACTION/GOTO tables as a TableFile; not
+    // for lazy tables
+    void save(const std::string& path) const;
+    // Maps a file written by save(). The ACTION/GOTO and rule arrays are
+    // used in place and stay mapped for the lifetime of the result. The
+    // compressed form is not stored; `compress` rebuilds it from the mapping.
+    static SharedParseTables load(const std::string& path, bool compress = false);
+
+    const SymbolTable& symbols() const { return symbolTable; }
+    // The rules' right-hand sides, e.g. for CodeGenerator's comments; null
+    // for tables loaded from a file, which only keep the rule lengths
+    const Grammar* grammar() const { return sourceGrammar.get(); }
+    const ParseTableView& table() const { return denseView; }
+    bool isCompressed() const { return compressed; }
+    size_t conflictCount() const { return automaton ? automaton->conflictCount() : conflicts; }
+    const CompressedParseTable& compressedTable() const { return packedTable; }
+    bool isLazy() const { return automaton != nullptr; }
+    const LazyAutomaton* lazyAutomaton() const { return automaton.get(); }   // null unless lazy
+
+    // Terminal ID of a token's text, or -1 if it names no terminal
+    int terminal(std::string_view text) const {
+        auto id = terminalIds.find(text);
+        return id == terminalIds.end() ? -1 : id->second;
+    }
+
+    ParseTable::Result parse(const std::vector<int>& tokens, std::vector<int>& stack) const {
+        if (automaton) return automaton->parse(tokens, stack);
+        return compressed ? packedTable.parse(tokens, stack) : denseView.parse(tokens, stack);
+    }
+    // The same, building the parse tree into `tree` (cleared first)
+    ParseTable::Result parse(const std::vector<int>& tokens, std::vector<int>& stack, SyntaxTree& tree) const;
+    // The same, reporting each shift and reduction to `listener`, e.g.
+    // SemanticActions (see LRDriver.h)
+    template <typename Listener>
+    ParseTable::Result parse(const std::vector<int>& tokens, std::vector<int>& stack, Listener& listener) const {
+        if (automaton) return runLRParser(*automaton, tokens, stack, listener);
+        return compressed ? runLRParser(packedTable, tokens, stack, listener)
+                          : runLRParser(denseView, tokens, stack, listener);
+    }
+
+private:
+    SymbolTable symbolTable;
+    SharedGrammar sourceGrammar;        // null when loaded
+    std::unique_ptr<TableFile> file;    // backs denseView when loaded
+    ParseTable denseTable;              // backs denseView when generated
+    ParseTableView denseView;
+    CompressedParseTable packedTable;
+    std::unique_ptr<LazyAutomaton> automaton;   // lazy tables only
+    bool compressed;
+    size_t conflicts;
+    std::unordered_map<std::string_view, int> terminalIds;   // views into symbolTable
+
+    ParseTables(const SymbolTable& symbols, std::unique_ptr<TableFile> mapped, bool compress);
+    void indexTerminals();
+};
@@ -0,0 +1,82 @@
+// SemanticActions.h
+#pragma once
+#include "ParseTables.h"
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct NoSemanticContext {};
+
+// Per-rule semantic actions over a typed value stack, for evaluators and
+// translators that run directly on the parser. Actions are plain function
+// pointers (captureless lambdas convert) in a flat table indexed by rule
+// number. A reduction makes one indirect call, with no virtual dispatch and
+// no std::function.
+//
+// A token's value comes from the token action. A reduction passes its
+// right-hand side values to the rule's action as a writable range, so the
+// action can move from them. Its result replaces them on the stack. Without
+// an action, a rule yields its first value moved (or Value() if it is empty).
+// Context carries state such as the token text into the actions.
+//
+// The tables are immutable once set up, so threads can share one instance,
+// each with its own scratch stacks. For dispatch that resolves fully at
+// compile time, pass your own listener to ParseTables::parse().
+template <typename Value, typename Context = NoSemanticContext>
+class SemanticActions {
+public:
+    typedef Value (*ReduceAction)(Context& context, Value* rhs, int length);
+    typedef Value (*TokenAction)(Context& context, int terminal, size_t position);
+
+    explicit SemanticActions(const ParseTables& tables)
+        : reduceActions(tables.table().ruleCount(), nullptr), tokenAction(nullptr) {}
+
+    // `rule` is a rule number as in ParseTable (see CanonicalLRParser::getRuleNumber)
+    void on(int rule, ReduceAction action) {
+        if (rule < 0 || rule >= static_cast<int>(reduceActions.size())) {
+            throw std::runtime_error("Semantic action for unknown rule " + std::to_string(rule));
+        }
+        reduceActions[rule] = action;
+    }
+    void onToken(TokenAction action) { tokenAction = action; }
+
+    // Parses `tokens` running the actions. When the input is accepted,
+    // `result` receives the start symbol's value. `stack` and `values` are
+    // scratch space the caller may reuse across calls.
+    ParseTable::Result parse(const ParseTables& tables, const std::vector<int>& tokens, Context& context,
+                             Value& result, std::vector<int>& stack, std::vector<Value>& values) const {
+        values.clear();
+        Evaluator evaluator = {*this, context, values};
+        ParseTable::Result parsed = tables.parse(tokens, stack, evaluator);
+        if (parsed.accepted && !values.empty()) {
+            result = std::move(values.back());
+        }
+        values.clear();
+        return parsed;
+    }
+
+private:
+    std::vector<ReduceAction> reduceActions;   // by rule number; null = default
+    TokenAction tokenAction;                   // null = Value()
+
+    // LRDriver listener that keeps one value per parse stack entry
+    struct Evaluator {
+        const SemanticActions& actions;
+        Context& context;
+        std::vector<Value>& values;
+
+        void shift(int terminal, size_t position) {
+            values.push_back(actions.tokenAction ? actions.tokenAction(context, terminal, position) : Value());
+        }
+        void reduce(int rule, int /*lhs*/, int length, size_t /*position*/) {
+            Value* rhs = values.data() + (values.size() - length);
+            ReduceAction action = actions.reduceActions[rule];
+            Value lhs = action ? action(context, rhs, length) : (length > 0 ? std::move(rhs[0]) : Value());
+            values.erase(values.end() - length, values.end());
+            values.push_back(std::move(lhs));
+        }
+        void accept() {}
+    };
+};
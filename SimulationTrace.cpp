@@ -0,0 +1,65 @@
+// SimulationTrace.cpp
+#include "SimulationTrace.h"
+#include <algorithm>
+
+void SimulationTrace::start() {
+    nodes.clear();
+    steps.clear();
+    nodes.push_back({0, -1, 0});
+    steps.push_back({ParseTable::makeAction(ParseTable::Error, 0), 0, 0, Running});
+}
+
+uint32_t SimulationTrace::push(uint32_t parent, int state, int symbol) {
+    nodes.push_back({state, symbol, parent});
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void SimulationTrace::advance(const ParseTables& tables, int terminal) {
+    if (finished()) return;
+    if (tables.isLazy()) {
+        advanceOn(*tables.lazyAutomaton(), terminal);
+    } else {
+        advanceOn(tables.table(), terminal);
+    }
+}
+
+template <typename Table>
+void SimulationTrace::advanceOn(const Table& table, int terminal) {
+    Step next = steps.back();
+    ParseTable::Action action = (terminal >= 0 && terminal < table.terminalCount())
+        ? table.action(nodes[next.top].state, terminal)
+        : ParseTable::makeAction(ParseTable::Error, 0);
+    next.action = action;
+
+    switch (ParseTable::kind(action)) {
+    case ParseTable::Shift:
+        next.top = push(next.top, ParseTable::value(action), terminal);
+        next.inputPointer++;
+        break;
+    case ParseTable::Reduce: {
+        const ParseTable::Rule& rule = table.rule(ParseTable::value(action));
+        uint32_t base = next.top;
+        for (int i = 0; i < rule.length && base != 0; ++i) {
+            base = nodes[base].parent;
+        }
+        next.top = push(base, table.gotoState(nodes[base].state, rule.lhs), table.terminalCount() + rule.lhs);
+        break;
+    }
+    case ParseTable::Accept:
+        next.status = Accepted;
+        break;
+    default:
+        next.status = Rejected;
+        break;
+    }
+
+    steps.push_back(next);
+}
+
+void SimulationTrace::stack(size_t index, std::vector<Entry>& entries) const {
+    entries.clear();
+    for (uint32_t node = steps[index].top; node != 0; node = nodes[node].parent) {
+        entries.push_back({nodes[node].state, nodes[node].symbol});
+    }
+    std::reverse(entries.begin(), entries.end());
+}
@@ -0,0 +1,58 @@
+// SimulationTrace.h
+#pragma once
+#include "ParseTable.h"
+#include "ParseTables.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Step-by-step record of an LR parse for the simulation view. A step stores
+// only the action that produced it and a handle to its stack. Stacks are
+// nodes linked to their parent and shared between steps, so a shift or
+// reduce adds a single node, and any earlier step's stack can still be read
+// without replaying the parse.
+class SimulationTrace {
+public:
+    enum Status : uint8_t { Running, Accepted, Rejected };
+
+    struct Step {
+        ParseTable::Action action;   // that led here; an Error word for the first step
+        uint32_t top;                // stack node
+        uint32_t inputPointer;       // tokens consumed
+        Status status;
+    };
+
+    struct Entry {
+        int state;
+        int symbol;   // symbol ID shifted or reduced to
+    };
+
+    // Clears the trace and records the initial step: state 0, no input read
+    void start();
+
+    // Appends the step that follows the last one. `terminal` is the ID of
+    // the token at the last step's input pointer (negative if unknown).
+    void advance(const ParseTables& tables, int terminal);
+
+    size_t size() const { return steps.size(); }
+    const Step& step(size_t index) const { return steps[index]; }
+    const Step& last() const { return steps.back(); }
+    bool finished() const { return !steps.empty() && steps.back().status != Running; }
+
+    // The stack of step `index` from bottom to top, without the initial state
+    void stack(size_t index, std::vector<Entry>& entries) const;
+
+private:
+    struct Node {
+        int32_t state;
+        int32_t symbol;
+        uint32_t parent;
+    };
+
+    std::vector<Node> nodes;   // node 0 is the initial state
+    std::vector<Step> steps;
+
+    uint32_t push(uint32_t parent, int state, int symbol);
+    template <typename Table>
+    void advanceOn(const Table& table, int terminal);
+};
@@ -0,0 +1,67 @@
+// SymbolTable.cpp
+#include "SymbolTable.h"
+
+const char* const SymbolTable::epsilon = "ε";
+
+SymbolTable::SymbolTable(const std::map<std::string, std::vector<std::vector<std::string>>>& prod) {
+    intern("$");
+
+    // Terminals: every right-hand side symbol without productions of its own
+    for (const auto& production : prod) {
+        for (const auto& rule : production.second) {
+            for (const auto& symbol : rule) {
+                if (symbol != epsilon && prod.find(symbol) == prod.end()) {
+                    intern(symbol);
+                }
+            }
+        }
+    }
+    terminals = static_cast<int>(names.size());
+
+    // Non-terminals, in the grammar's (sorted) order
+    for (const auto& production : prod) {
+        intern(production.first);
+    }
+}
+
+SymbolTable::SymbolTable(const std::vector<std::string>& namesById, int terminalCount) {
+    for (const auto& symbol : namesById) {
+        intern(symbol);
+    }
+    terminals = terminalCount;
+}
+
+int SymbolTable::intern(const std::string& symbol) {
+    auto inserted = ids.emplace(symbol, static_cast<int>(names.size()));
+    if (inserted.second) {
+        names.push_back(symbol);
+    }
+    return inserted.first->second;
+}
+
+int SymbolTable::id(const std::string& symbol) const {
+    auto found = ids.find(symbol);
+    return found == ids.end() ? -1 : found->second;
+}
+
+const std::string& SymbolTable::name(int id) const {
+    return names.at(id);
+}
+
+std::vector<Production> SymbolTable::flatten(
+    const std::map<std::string, std::vector<std::vector<std::string>>>& prod) const {
+    std::vector<Production> productions;
+    for (const auto& production : prod) {
+        int lhs = id(production.first);
+        for (const auto& rule : production.second) {
+            Production flat = {lhs, {}};
+            for (const auto& symbol : rule) {
+                if (symbol != epsilon) {
+                    flat.rhs.push_back(id(symbol));
+                }
+            }
+            productions.push_back(flat);
+        }
+    }
+    return productions;
+}
@@ -0,0 +1,48 @@
+// SymbolTable.h
+#pragma once
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A production with interned symbols. Productions are numbered in grammar
+// order (non-terminals sorted, alternatives as written); that number is the
+// rule number used in the ACTION table.
+struct Production {
+    int lhs;
+    std::vector<int> rhs;
+};
+
+// Interns every grammar symbol to a dense integer ID. Terminals come first
+// (the end marker "$" is always ID 0), so a terminal ID can be used directly
+// as a column or bit index; nonterminals follow. "ε" is not a symbol: it only
+// marks an empty right-hand side.
+class SymbolTable {
+public:
+    static const int endMarker = 0;
+    static const char* const epsilon;
+
+    SymbolTable() = default;
+    explicit SymbolTable(const std::map<std::string, std::vector<std::vector<std::string>>>& prod);
+    // Restores a table from its names in ID order, terminals first
+    SymbolTable(const std::vector<std::string>& namesById, int terminalCount);
+
+    int id(const std::string& symbol) const;  // -1 for unknown symbols
+    const std::string& name(int id) const;
+    bool isTerminal(int id) const { return id < terminals; }
+
+    int terminalCount() const { return terminals; }
+    int nonTerminalCount() const { return static_cast<int>(names.size()) - terminals; }
+    int size() const { return static_cast<int>(names.size()); }
+
+    // Numbered productions over symbol IDs; "ε" right-hand sides become empty
+    std::vector<Production> flatten(
+        const std::map<std::string, std::vector<std::vector<std::string>>>& prod) const;
+
+private:
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> ids;
+    int terminals = 0;
+
+    int intern(const std::string& symbol);
+};
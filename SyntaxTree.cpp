@@ -0,0 +1,86 @@
+// SyntaxTree.cpp
+#include "SyntaxTree.h"
+#include <ostream>
+#include <utility>
+
+SyntaxTree::SyntaxTree(Mode mode)
+    : mode(mode), rootNode(none) {}
+
+void SyntaxTree::clear() {
+    nodes.clear();
+    children.clear();
+    pending.clear();
+    rootNode = none;
+}
+
+void SyntaxTree::setMode(Mode newMode) {
+    mode = newMode;
+}
+
+size_t SyntaxTree::byteSize() const {
+    return nodes.capacity() * sizeof(Node) +
+           (children.capacity() + pending.capacity()) * sizeof(uint32_t);
+}
+
+void SyntaxTree::shift(int terminal, size_t position) {
+    pending.push_back(static_cast<uint32_t>(nodes.size()));
+    nodes.push_back({terminal, -1, static_cast<uint32_t>(position), 1, 0, 0});
+}
+
+void SyntaxTree::reduce(int rule, int lhs, int length, size_t position) {
+    if (mode == Abstract && length == 1) {
+        return;  // the child stands in for its parent
+    }
+
+    Node parent = {lhs, rule, static_cast<uint32_t>(position), 0,
+                   static_cast<uint32_t>(children.size()), static_cast<uint32_t>(length)};
+    size_t first = pending.size() - length;
+    if (length > 0) {
+        const Node& firstChild = nodes[pending[first]];
+        parent.firstToken = firstChild.firstToken;
+        parent.tokenCount = static_cast<uint32_t>(position) - firstChild.firstToken;
+    }
+    children.insert(children.end(), pending.begin() + first, pending.end());
+    pending.resize(first);
+
+    pending.push_back(static_cast<uint32_t>(nodes.size()));
+    nodes.push_back(parent);
+}
+
+void SyntaxTree::accept() {
+    rootNode = pending.empty() ? none : pending.back();
+}
+
+void SyntaxTree::write(std::ostream& os, const SymbolTable& symbols) const {
+    if (root() == none) {
+        os << "()\n";
+        return;
+    }
+
+    // Iterative, since right-recursive grammars nest as deep as the input
+    std::vector<std::pair<uint32_t, uint32_t>> open;   // node, next child
+    open.push_back({root(), 0});
+    bool first = true;
+    while (!open.empty()) {
+        auto& [index, next] = open.back();
+        const Node& current = nodes[index];
+        if (next == 0) {
+            if (!first) os << " ";
+            first = false;
+            if (current.isToken()) {
+                os << symbols.name(current.symbol);
+                open.pop_back();
+                continue;
+            }
+            os << "(" << symbols.name(current.symbol);
+        }
+        if (next < current.childCount) {
+            uint32_t childIndex = child(current, next++);
+            open.push_back({childIndex, 0});
+        } else {
+            os << ")";
+            open.pop_back();
+        }
+    }
+    os << "\n";
+}
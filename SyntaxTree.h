@@ -0,0 +1,62 @@
+// SyntaxTree.h
+#pragma once
+#include "SymbolTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// Parse tree built from the driver's shifts and reductions (it is an
+// LRDriver listener). Nodes live in one flat array and refer to each other
+// by index. Each node's children are a contiguous range of one shared child
+// index array, and tokens are referenced by their position in the input.
+// clear() keeps the capacity, so a tree reused across parses stops
+// allocating once it has grown to the largest input.
+class SyntaxTree {
+public:
+    // Concrete keeps a node for every reduction. Abstract drops reductions
+    // by single-symbol rules (chains such as E -> T -> F) and lets the child
+    // stand in for them.
+    enum Mode { Concrete, Abstract };
+
+    static constexpr uint32_t none = UINT32_MAX;
+
+    struct Node {
+        int32_t symbol;        // terminal or non-terminal ID
+        int32_t rule;          // rule reduced, -1 for a token
+        uint32_t firstToken;   // index of the first token covered
+        uint32_t tokenCount;   // 1 for a token, 0 for an empty reduction
+        uint32_t firstChild;   // into the child index array
+        uint32_t childCount;
+
+        bool isToken() const { return rule < 0; }
+    };
+
+    explicit SyntaxTree(Mode mode = Concrete);
+
+    void clear();
+    void setMode(Mode mode);   // call between parses
+    Mode getMode() const { return mode; }
+
+    // Root of the accepted parse; none since clear() until one is accepted
+    uint32_t root() const { return rootNode; }
+    size_t size() const { return nodes.size(); }
+    const Node& node(uint32_t index) const { return nodes[index]; }
+    uint32_t child(const Node& parent, uint32_t index) const { return children[parent.firstChild + index]; }
+    size_t byteSize() const;
+
+    // Writes the tree as nested "(symbol child ...)" lists, one line
+    void write(std::ostream& os, const SymbolTable& symbols) const;
+
+    // Listener hooks, called by runLRParser()
+    void shift(int terminal, size_t position);
+    void reduce(int rule, int lhs, int length, size_t position);
+    void accept();
+
+private:
+    Mode mode;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> children;
+    std::vector<uint32_t> pending;   // roots of the subtrees on the parse stack
+    uint32_t rootNode;
+};
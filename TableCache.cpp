@@ -0,0 +1,185 @@
+// TableCache.cpp
+#include "TableCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+const char* const TableCache::generatorVersion = "1";
+
+namespace {
+
+uint64_t fnv1a(const std::string& text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Unique temporary name beside `path`, so the final rename stays on one volume
+std::string temporaryPath(const std::string& path) {
+    std::ostringstream name;
+    name << path << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id())
+         << "-" << std::chrono::steady_clock::now().time_since_epoch().count();
+    return name.str();
+}
+
+bool isTemporary(const fs::path& path) {
+    return path.extension().string().compare(0, 4, ".tmp") == 0;
+}
+
+// Writers rename their temporaries within moments, so one this old was left
+// by a process that died
+const auto staleTemporaryAge = std::chrono::hours(1);
+
+}
+
+TableCache::TableCache(const std::string& directory, uint64_t maxBytes)
+    : directory(directory), maxBytes(maxBytes) {
+    std::error_code error;
+    fs::create_directories(directory, error);
+}
+
+std::string TableCache::key(const SymbolTable& symbols, const std::vector<Production>& productions,
+                            ConstructionMode mode) {
+    std::ostringstream text;
+    text << "generator " << generatorVersion << "\n"
+         << "format " << TableFile::version << "\n"
+         << "mode " << constructionModeName(mode) << "\n"
+         << "terminals " << symbols.terminalCount() << "\n";
+    for (const Production& production : productions) {
+        text << symbols.name(production.lhs) << " ->";
+        for (int symbol : production.rhs) {
+            text << " " << symbols.name(symbol);
+        }
+        text << "\n";
+    }
+    return text.str();
+}
+
+std::string TableCache::pathOf(const std::string& key, const char* extension) const {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(fnv1a(key)));
+    return (fs::path(directory) / (std::string(name) + extension)).string();
+}
+
+SharedParseTables TableCache::find(const std::string& key, bool compress) {
+    std::string tablePath = pathOf(key, ".tbl");
+    std::ifstream keyFile(pathOf(key, ".key"), std::ios::binary);
+    std::ostringstream storedKey;
+    storedKey << keyFile.rdbuf();
+
+    if (keyFile.is_open() && storedKey.str() == key) {
+        try {
+            SharedParseTables tables = ParseTables::load(tablePath, compress);
+            std::error_code error;
+            fs::last_write_time(tablePath, fs::file_time_type::clock::now(), error);
+            stats.hits++;
+            return tables;
+        } catch (const std::exception&) {
+            // Unreadable entry: drop it and rebuild
+            std::error_code error;
+            fs::remove(tablePath, error);
+        }
+    }
+    stats.misses++;
+    return nullptr;
+}
+
+void TableCache::store(const std::string& key, const ParseTables& tables) {
+    std::string tablePath = pathOf(key, ".tbl");
+    std::string keyPath = pathOf(key, ".key");
+    std::string tableTemp = temporaryPath(tablePath);
+    std::string keyTemp = temporaryPath(keyPath);
+
+    try {
+        tables.save(tableTemp);
+        std::ofstream keyFile(keyTemp, std::ios::binary | std::ios::trunc);
+        keyFile << key;
+        keyFile.close();
+        if (!keyFile) {
+            throw std::runtime_error("Could not write '" + keyTemp + "'");
+        }
+        // The table goes first, so a matching key always has a complete table
+        fs::rename(tableTemp, tablePath);
+        fs::rename(keyTemp, keyPath);
+        stats.stores++;
+    } catch (const std::exception&) {
+        std::error_code error;
+        fs::remove(tableTemp, error);
+        fs::remove(keyTemp, error);
+        return;
+    }
+
+    evict(tablePath);
+}
+
+uint64_t TableCache::totalBytes() const {
+    uint64_t total = 0;
+    std::error_code error;
+    for (fs::directory_iterator entry(directory, error), end; !error && entry != end; entry.increment(error)) {
+        std::error_code sizeError;
+        uint64_t size = entry->file_size(sizeError);
+        if (!sizeError) total += size;
+    }
+    return total;
+}
+
+void TableCache::evict(const std::string& keep) {
+    struct Entry {
+        fs::path table;
+        fs::file_time_type used;
+        uint64_t bytes;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    std::error_code error;
+    const fs::file_time_type now = fs::file_time_type::clock::now();
+    for (fs::directory_iterator entry(directory, error), end; !error && entry != end; entry.increment(error)) {
+        std::error_code entryError;
+        if (isTemporary(entry->path())) {
+            fs::file_time_type written = entry->last_write_time(entryError);
+            if (!entryError && now - written > staleTemporaryAge) {
+                fs::remove(entry->path(), entryError);
+            }
+            continue;
+        }
+        // Only entries count, each with its key
+        if (entry->path().extension() != ".tbl") continue;
+        uint64_t size = entry->file_size(entryError);
+        if (entryError) continue;
+        fs::path keyPath = entry->path();
+        keyPath.replace_extension(".key");
+        uint64_t keySize = fs::file_size(keyPath, entryError);
+        if (!entryError) size += keySize;
+        total += size;
+        entries.push_back({entry->path(), entry->last_write_time(entryError), size});
+    }
+    if (total <= maxBytes) return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.used < b.used;
+    });
+    for (const Entry& entry : entries) {
+        if (total <= maxBytes) break;
+        if (entry.table == fs::path(keep)) continue;
+        fs::path keyPath = entry.table;
+        keyPath.replace_extension(".key");
+        // Key first: an entry without its key is never looked up
+        fs::remove(keyPath, error);
+        if (fs::remove(entry.table, error)) {
+            total -= std::min(total, entry.bytes);
+            stats.evictions++;
+        }
+    }
+}
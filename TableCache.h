@@ -0,0 +1,56 @@
+// TableCache.h
+#pragma once
+#include "ItemSetGenerator.h"
+#include "ParseTables.h"
+#include "SymbolTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// On-disk cache of generated tables, addressed by a hash of the normalized
+// grammar, the construction mode and the generator version. Each entry is a
+// TableFile (<hash>.tbl) plus the full key text (<hash>.key), which is
+// compared on lookup so a hash collision can only cost a miss. Entries are
+// written through a temporary file and renamed into place, so processes can
+// share one directory. When the entries grow past the size limit the least
+// recently used ones are removed, along with temporary files that a writer
+// which crashed left behind an hour or more ago.
+//
+// The cache is best effort: I/O errors and unreadable entries count as
+// misses and never fail table generation.
+class TableCache {
+public:
+    // Bump whenever generation can produce different tables for the same
+    // grammar and mode, to retire every existing entry.
+    static const char* const generatorVersion;
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t stores = 0;
+        size_t evictions = 0;
+    };
+
+    TableCache(const std::string& directory, uint64_t maxBytes);
+
+    // Canonical key text: versions, mode and every rule in rule order
+    static std::string key(const SymbolTable& symbols, const std::vector<Production>& productions,
+                           ConstructionMode mode);
+
+    // Null on a miss; `compress` as for ParseTables::load()
+    SharedParseTables find(const std::string& key, bool compress = false);
+    void store(const std::string& key, const ParseTables& tables);
+
+    const Stats& getStats() const { return stats; }
+    uint64_t totalBytes() const;
+    const std::string& getDirectory() const { return directory; }
+
+private:
+    std::string directory;
+    uint64_t maxBytes;
+    Stats stats;
+
+    std::string pathOf(const std::string& key, const char* extension) const;
+    void evict(const std::string& keep);
+};
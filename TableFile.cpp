@@ -0,0 +1,249 @@
+// TableFile.cpp
+#include "TableFile.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char magic[8] = {'C', 'L', 'R', 'T', 'A', 'B', 'L', 'E'};
+static_assert(sizeof(ParseTable::Rule) == 8, "RULES entries are used in place as ParseTable::Rule");
+const size_t headerSize = 8 + 8 * 4 + 5 * 8;
+
+void put32(std::vector<unsigned char>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) out.push_back(static_cast<unsigned char>(value >> shift));
+}
+
+void put64(std::vector<unsigned char>& out, uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) out.push_back(static_cast<unsigned char>(value >> shift));
+}
+
+void align8(std::vector<unsigned char>& out) {
+    while (out.size() % 8 != 0) out.push_back(0);
+}
+
+uint32_t get32(const unsigned char* in) {
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+uint64_t get64(const unsigned char* in) {
+    return static_cast<uint64_t>(get32(in)) | (static_cast<uint64_t>(get32(in + 4)) << 32);
+}
+
+}
+
+void TableFile::write(const std::string& path, const SymbolTable& symbols, const ParseTableView& table,
+                      uint32_t conflicts) {
+    const uint32_t states = table.stateCount();
+    const uint32_t terminals = table.terminalCount();
+    const uint32_t nonTerminals = table.nonTerminalCount();
+    const uint32_t rules = table.ruleCount();
+
+    std::vector<unsigned char> body;
+    const uint64_t actionOffset = headerSize + body.size();
+    for (uint32_t state = 0; state < states; ++state) {
+        for (uint32_t terminal = 0; terminal < terminals; ++terminal) {
+            put32(body, table.action(state, terminal));
+        }
+    }
+    align8(body);
+    const uint64_t gotoOffset = headerSize + body.size();
+    for (uint32_t state = 0; state < states; ++state) {
+        for (uint32_t nonTerminal = 0; nonTerminal < nonTerminals; ++nonTerminal) {
+            put32(body, static_cast<uint32_t>(table.gotoState(state, nonTerminal)));
+        }
+    }
+    align8(body);
+    const uint64_t ruleOffset = headerSize + body.size();
+    for (uint32_t rule = 0; rule < rules; ++rule) {
+        put32(body, static_cast<uint32_t>(table.ruleLhs(rule)));
+        put32(body, static_cast<uint32_t>(table.ruleLength(rule)));
+    }
+    align8(body);
+    const uint64_t nameOffset = headerSize + body.size();
+    uint32_t nameBytes = 0;
+    for (int symbol = 0; symbol < symbols.size(); ++symbol) {
+        put32(body, nameBytes);
+        nameBytes += static_cast<uint32_t>(symbols.name(symbol).size());
+    }
+    put32(body, nameBytes);
+    for (int symbol = 0; symbol < symbols.size(); ++symbol) {
+        const std::string& name = symbols.name(symbol);
+        body.insert(body.end(), name.begin(), name.end());
+    }
+    align8(body);
+
+    std::vector<unsigned char> header(magic, magic + sizeof(magic));
+    put32(header, version);
+    put32(header, states);
+    put32(header, terminals);
+    put32(header, nonTerminals);
+    put32(header, rules);
+    put32(header, nameBytes);
+    put32(header, conflicts);
+    put32(header, 0);
+    put64(header, actionOffset);
+    put64(header, gotoOffset);
+    put64(header, ruleOffset);
+    put64(header, nameOffset);
+    put64(header, headerSize + body.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    out.write(reinterpret_cast<const char*>(body.data()), body.size());
+    if (!out) {
+        throw std::runtime_error("Could not write table file '" + path + "'");
+    }
+}
+
+bool TableFile::isTableFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char start[sizeof(magic)];
+    return in.read(start, sizeof(start)) && std::memcmp(start, magic, sizeof(magic)) == 0;
+}
+
+bool TableFile::inPlace() {
+    const uint32_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1 && sizeof(ParseTable::Action) == 4;
+}
+
+TableFile::TableFile(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        throw std::runtime_error("Could not open table file '" + path + "'");
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+    mapping = length > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if (mapping) {
+        data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (file < 0 || ::fstat(file, &info) != 0) {
+        if (file >= 0) ::close(file);
+        throw std::runtime_error("Could not open table file '" + path + "'");
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+        data = address == MAP_FAILED ? nullptr : static_cast<const unsigned char*>(address);
+    }
+    ::close(file);
+#endif
+
+    if (!data || length < headerSize || std::memcmp(data, magic, sizeof(magic)) != 0) {
+        unmap();
+        throw std::runtime_error("'" + path + "' is not a parse table file");
+    }
+    const uint32_t fileVersion = get32(data + 8);
+    if (fileVersion != version) {
+        unmap();
+        throw std::runtime_error("'" + path + "' has unsupported table format version " +
+                                 std::to_string(fileVersion));
+    }
+
+    states = get32(data + 12);
+    terminals = get32(data + 16);
+    nonTerminals = get32(data + 20);
+    rules = get32(data + 24);
+    nameBytes = get32(data + 28);
+    conflicts = get32(data + 32);
+    actionOffset = get64(data + 40);
+    gotoOffset = get64(data + 48);
+    ruleOffset = get64(data + 56);
+    nameOffset = get64(data + 64);
+
+    // Sections must sit exactly where write() puts them for these counts
+    const uint64_t symbols = static_cast<uint64_t>(terminals) + nonTerminals;
+    auto align8 = [](uint64_t offset) { return (offset + 7) / 8 * 8; };
+    const uint64_t expectedGoto = align8(headerSize + static_cast<uint64_t>(states) * terminals * 4);
+    const uint64_t expectedRule = align8(expectedGoto + static_cast<uint64_t>(states) * nonTerminals * 4);
+    const uint64_t expectedName = align8(expectedRule + static_cast<uint64_t>(rules) * 8);
+    const uint64_t expectedSize = align8(expectedName + (symbols + 1) * 4 + nameBytes);
+    if (actionOffset != headerSize || gotoOffset != expectedGoto || ruleOffset != expectedRule ||
+        nameOffset != expectedName || get64(data + 72) != expectedSize || expectedSize != length ||
+        get32(data + nameOffset + symbols * 4) != nameBytes) {
+        unmap();
+        throw std::runtime_error("'" + path + "' is truncated or corrupt");
+    }
+}
+
+TableFile::~TableFile() {
+    unmap();
+}
+
+void TableFile::unmap() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(mapping);
+    mapping = nullptr;
+#else
+    if (data) ::munmap(const_cast<unsigned char*>(data), length);
+#endif
+    data = nullptr;
+}
+
+ParseTableView TableFile::view() const {
+    if (!inPlace()) {
+        throw std::runtime_error("Table file arrays can't be used in place on this host");
+    }
+    return ParseTableView(static_cast<int>(states), static_cast<int>(terminals),
+                          static_cast<int>(nonTerminals), static_cast<int>(rules),
+                          reinterpret_cast<const ParseTable::Action*>(data + actionOffset),
+                          reinterpret_cast<const int32_t*>(data + gotoOffset),
+                          reinterpret_cast<const ParseTable::Rule*>(data + ruleOffset));
+}
+
+ParseTable TableFile::decode() const {
+    ParseTable table(static_cast<int>(states), static_cast<int>(terminals), static_cast<int>(nonTerminals));
+    for (uint32_t state = 0; state < states; ++state) {
+        for (uint32_t terminal = 0; terminal < terminals; ++terminal) {
+            table.setAction(state, terminal, get32(data + actionOffset + (static_cast<uint64_t>(state) * terminals + terminal) * 4));
+        }
+        for (uint32_t nonTerminal = 0; nonTerminal < nonTerminals; ++nonTerminal) {
+            table.setGoto(state, nonTerminal, static_cast<int32_t>(
+                get32(data + gotoOffset + (static_cast<uint64_t>(state) * nonTerminals + nonTerminal) * 4)));
+        }
+    }
+    for (uint32_t rule = 0; rule < rules; ++rule) {
+        table.setRule(rule, static_cast<int32_t>(get32(data + ruleOffset + rule * 8)),
+                      static_cast<int32_t>(get32(data + ruleOffset + rule * 8 + 4)));
+    }
+    return table;
+}
+
+SymbolTable TableFile::symbols() const {
+    const uint32_t count = terminals + nonTerminals;
+    const unsigned char* offsets = data + nameOffset;
+    const char* bytes = reinterpret_cast<const char*>(offsets + (count + 1) * 4);
+
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (uint32_t symbol = 0; symbol < count; ++symbol) {
+        uint32_t begin = get32(offsets + symbol * 4);
+        uint32_t end = get32(offsets + (symbol + 1) * 4);
+        if (begin > end || end > nameBytes) {
+            throw std::runtime_error("Table file has a corrupt symbol name table");
+        }
+        names.emplace_back(bytes + begin, end - begin);
+    }
+    return SymbolTable(names, static_cast<int>(terminals));
+}
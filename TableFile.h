@@ -0,0 +1,71 @@
+// TableFile.h
+#pragma once
+#include "ParseTable.h"
+#include "SymbolTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary parse-table file. All integers are little-endian and every section
+// starts on an 8-byte boundary, so on little-endian hosts the arrays are used
+// straight from a read-only mapping with no parsing or copying:
+//
+//   header   "CLRTABLE", uint32 version, states, terminals, nonTerminals,
+//            rules, nameBytes, conflicts (resolved while generating) and a
+//            zero pad, then uint64 offsets of the ACTION, GOTO, RULES and
+//            NAMES sections and the file size
+//   ACTION   uint32[states * terminals], one row per state
+//   GOTO     int32[states * nonTerminals], one row per state, -1 = none
+//   RULES    int32 left-hand side and int32 length of each rule, in pairs
+//            (ParseTable::Rule)
+//   NAMES    uint32[symbols + 1] offsets into the name bytes that follow
+//            (UTF-8, unterminated), symbols in ID order
+//
+// A reader rejects any other version, and any file whose sections are not
+// exactly where the counts put them; the table contents themselves are
+// trusted. Bump the version whenever the layout changes.
+class TableFile {
+public:
+    static const uint32_t version = 3;
+
+    static void write(const std::string& path, const SymbolTable& symbols, const ParseTableView& table,
+                      uint32_t conflicts);
+    static bool isTableFile(const std::string& path);  // checks the magic only
+
+    // Maps the file and checks its header; throws std::runtime_error if it
+    // can't be opened or isn't a table file of this version.
+    explicit TableFile(const std::string& path);
+    ~TableFile();
+    TableFile(const TableFile&) = delete;
+    TableFile& operator=(const TableFile&) = delete;
+
+    // The arrays in place; only on little-endian hosts (see inPlace())
+    ParseTableView view() const;
+    // A decoded copy, for hosts that can't use the arrays in place
+    ParseTable decode() const;
+    static bool inPlace();
+
+    SymbolTable symbols() const;
+    uint32_t conflictCount() const { return conflicts; }
+    size_t size() const { return length; }
+
+private:
+    const unsigned char* data = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* mapping = nullptr;
+#endif
+    uint32_t states = 0;
+    uint32_t terminals = 0;
+    uint32_t nonTerminals = 0;
+    uint32_t rules = 0;
+    uint32_t nameBytes = 0;
+    uint32_t conflicts = 0;
+    uint64_t actionOffset = 0;
+    uint64_t gotoOffset = 0;
+    uint64_t ruleOffset = 0;
+    uint64_t nameOffset = 0;
+
+    void unmap();
+};
@@ -0,0 +1,98 @@
+// ThreadPool.cpp
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = 1;
+    for (unsigned i = 0; i < threads; ++i) {
+        queues.emplace_back(new WorkQueue());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, unsigned)>& task) {
+    if (count == 0) return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // Deal contiguous blocks so neighbouring tasks start on the same worker
+    size_t perWorker = (count + workers.size() - 1) / workers.size();
+    for (size_t w = 0; w < workers.size(); ++w) {
+        std::lock_guard<std::mutex> queueLock(queues[w]->mutex);
+        for (size_t i = w * perWorker; i < count && i < (w + 1) * perWorker; ++i) {
+            queues[w]->tasks.push_back(i);
+        }
+    }
+
+    currentTask = &task;
+    remaining = count;
+    generation++;
+    wake.notify_all();
+
+    // Wait for the tasks and for every worker that joined this loop, so no
+    // worker still holds `task` when the next loop deals out its indices
+    done.wait(lock, [this] { return remaining == 0 && active == 0; });
+    currentTask = nullptr;
+}
+
+bool ThreadPool::takeTask(unsigned worker, size_t& index) {
+    {
+        WorkQueue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            index = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        WorkQueue& victim = *queues[(worker + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            index = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned worker) {
+    size_t seenGeneration = 0;
+    while (true) {
+        const std::function<void(size_t, unsigned)>* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+            task = currentTask;
+            if (!task) continue;  // woke after that loop had already finished
+            active++;
+        }
+
+        size_t index;
+        size_t finished = 0;
+        while (takeTask(worker, index)) {
+            (*task)(index, worker);
+            finished++;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        remaining -= finished;
+        active--;
+        if (remaining == 0 && active == 0) done.notify_all();
+    }
+}
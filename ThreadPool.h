@@ -0,0 +1,46 @@
+// ThreadPool.h
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads running one parallel loop at a time. Every
+// worker owns a deque of task indices: it takes work from the back of its own
+// deque and, once that runs dry, steals from the front of the others'.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    // Calls task(index, worker) for every index in [0, count) and returns
+    // once all of them have finished. worker is in [0, size()).
+    void parallelFor(size_t count, const std::function<void(size_t, unsigned)>& task);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    const std::function<void(size_t, unsigned)>* currentTask = nullptr;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    size_t generation = 0;
+    size_t remaining = 0;
+    unsigned active = 0;
+    bool stopping = false;
+
+    void workerLoop(unsigned worker);
+    bool takeTask(unsigned worker, size_t& index);
+};
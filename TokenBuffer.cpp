@@ -0,0 +1,27 @@
+// TokenBuffer.cpp
+#include "TokenBuffer.h"
+#include <utility>
+
+void TokenBuffer::assign(std::string input) {
+    text = std::move(input);
+    tokens.clear();
+    split(text, tokens);
+}
+
+void TokenBuffer::clear() {
+    text.clear();
+    tokens.clear();
+}
+
+void TokenBuffer::split(std::string_view line, std::vector<std::string_view>& out) {
+    size_t pos = 0;
+    while (true) {
+        pos = line.find_first_not_of(" \t\r\n", pos);
+        if (pos == std::string_view::npos) break;
+        size_t end = line.find_first_of(" \t\r\n", pos);
+        if (end == std::string_view::npos) end = line.size();
+
+        out.push_back(line.substr(pos, end - pos));
+        pos = end;
+    }
+}
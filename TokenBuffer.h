@@ -0,0 +1,30 @@
+// TokenBuffer.h
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Whitespace-separated input tokens as views into one owned copy of the
+// text, so tokens can be indexed without re-reading or re-splitting it.
+class TokenBuffer {
+public:
+    TokenBuffer() = default;
+    TokenBuffer(const TokenBuffer&) = delete;   // views point into `text`
+    TokenBuffer& operator=(const TokenBuffer&) = delete;
+
+    void assign(std::string input);
+    void clear();
+
+    size_t size() const { return tokens.size(); }
+    bool empty() const { return tokens.empty(); }
+    std::string_view operator[](size_t index) const { return tokens[index]; }
+    const std::string& getText() const { return text; }
+
+    // Appends the tokens of `line` to `out` as views into `line`
+    static void split(std::string_view line, std::vector<std::string_view>& out);
+
+private:
+    std::string text;
+    std::vector<std::string_view> tokens;
+};
@@ -1,8 +1,167 @@
 #include "mainwindow.h"
+#include "BatchParser.h"
+#include "CanonicalLRParser.h"
+#include "CodeGenerator.h"
+#include "TableFile.h"
 #include <QApplication>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+
+// Builds the tables for a grammar file, or maps them from a table file
+// written by --save-tables. `lazy` leaves a grammar's states to be built as
+// parsing reaches them.
+static SharedParseTables loadTables(const std::string& path, bool lazy = false)
+{
+    if (TableFile::isTableFile(path)) {
+        return ParseTables::load(path);
+    }
+
+    CanonicalLRParser parser;
+    parser.setGrammarFile(path);
+    parser.setLazyConstruction(lazy);
+    parser.run();
+    parser.generateParseTable();
+    return parser.getTables();
+}
+
+// Headless mode: CLRParserGUI --save-tables <grammar> <table file>
+static int runSaveTables(int argc, char *argv[])
+{
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " --save-tables <grammar> <table file>\n";
+        return 2;
+    }
+    loadTables(argv[2])->save(argv[3]);
+    return 0;
+}
+
+// Headless mode: CLRParserGUI --generate [--direct] <grammar|table file> <header> [namespace]
+// Writes the tables as a C++ header, or with --direct a directly executable
+// parser (see CodeGenerator.h)
+static int runGenerate(int argc, char *argv[])
+{
+    bool direct = argc > 2 && std::strcmp(argv[2], "--direct") == 0;
+    int first = direct ? 3 : 2;
+    if (argc != first + 2 && argc != first + 3) {
+        std::cerr << "Usage: " << argv[0] << " --generate [--direct] <grammar|table file> <header> [namespace]\n";
+        return 2;
+    }
+    SharedParseTables tables = loadTables(argv[first]);
+    CodeGenerator generator(*tables, argc == first + 3 ? argv[first + 2] : "grammar", argv[first]);
+    if (direct) {
+        generator.writeDirectHeader(argv[first + 1]);
+    } else {
+        generator.writeTableHeader(argv[first + 1]);
+    }
+    return 0;
+}
+
+// Headless mode: CLRParserGUI --generate-benchmark <grammar|table file> <directory>
+// Writes both header kinds and benchmark.cpp, which compares them
+static int runGenerateBenchmark(int argc, char *argv[])
+{
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " --generate-benchmark <grammar|table file> <directory>\n";
+        return 2;
+    }
+    SharedParseTables tables = loadTables(argv[2]);
+    std::string directory = argv[3];
+    CodeGenerator(*tables, "table_parser", argv[2]).writeTableHeader(directory + "/table_parser.h");
+    CodeGenerator(*tables, "direct_parser", argv[2]).writeDirectHeader(directory + "/direct_parser.h");
+    CodeGenerator::writeBenchmark(directory + "/benchmark.cpp", "table_parser.h", "table_parser",
+                                  "direct_parser.h", "direct_parser");
+    return 0;
+}
+
+// Headless mode: CLRParserGUI --batch [--tree|--ast] [--lazy] <grammar|table file> [input ...]
+// Parses one token sequence per line from each input file (stdin when none
+// or "-"), writes accept/reject per line to stdout and a summary to stderr.
+// --tree and --ast add the concrete or abstract parse tree of each accepted
+// sequence to its line. --lazy builds a grammar's states only as the input
+// reaches them.
+static int runBatch(int argc, char *argv[])
+{
+    int first = 2;
+    bool trees = false;
+    bool lazy = false;
+    SyntaxTree::Mode treeMode = SyntaxTree::Concrete;
+    for (; first < argc; ++first) {
+        if (std::strcmp(argv[first], "--tree") == 0 || std::strcmp(argv[first], "--ast") == 0) {
+            trees = true;
+            treeMode = std::strcmp(argv[first], "--ast") == 0 ? SyntaxTree::Abstract : SyntaxTree::Concrete;
+        } else if (std::strcmp(argv[first], "--lazy") == 0) {
+            lazy = true;
+        } else {
+            break;
+        }
+    }
+    if (argc < first + 1) {
+        std::cerr << "Usage: " << argv[0] << " --batch [--tree|--ast] [--lazy] <grammar|table file> [input ...]\n";
+        return 2;
+    }
+
+    SharedParseTables tables = loadTables(argv[first], lazy);
+    BatchParser batch(tables);
+    batch.setSyntaxTrees(trees, treeMode);
+
+    BatchParser::Report total;
+    auto add = [&total](const BatchParser::Report& report) {
+        total.sequences += report.sequences;
+        total.accepted += report.accepted;
+        total.rejected += report.rejected;
+        total.tokens += report.tokens;
+        total.seconds += report.seconds;
+    };
+
+    if (argc == first + 1) {
+        add(batch.parseStream(std::cin, &std::cout));
+    }
+    for (int i = first + 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-") == 0) {
+            add(batch.parseStream(std::cin, &std::cout));
+            continue;
+        }
+        std::ifstream input(argv[i]);
+        if (!input.is_open()) {
+            std::cerr << "Error: Could not open file '" << argv[i] << "'\n";
+            return 1;
+        }
+        add(batch.parseStream(input, &std::cout));
+    }
+
+    std::cerr << total.sequences << " sequences, " << total.accepted << " accepted, "
+              << total.rejected << " rejected, " << total.tokens << " tokens in "
+              << total.seconds << " s (" << static_cast<size_t>(total.tokensPerSecond())
+              << " tokens/s)\n";
+    if (const LazyAutomaton* automaton = tables->lazyAutomaton()) {
+        std::cerr << automaton->expandedCount() << " states built, " << automaton->stateCount()
+                  << " discovered\n";
+    }
+    return total.rejected == 0 ? 0 : 1;
+}
 
 int main(int argc, char *argv[])
 {
+    try {
+        if (argc > 1 && std::strcmp(argv[1], "--batch") == 0) {
+            return runBatch(argc, argv);
+        }
+        if (argc > 1 && std::strcmp(argv[1], "--save-tables") == 0) {
+            return runSaveTables(argc, argv);
+        }
+        if (argc > 1 && std::strcmp(argv[1], "--generate") == 0) {
+            return runGenerate(argc, argv);
+        }
+        if (argc > 1 && std::strcmp(argv[1], "--generate-benchmark") == 0) {
+            return runGenerateBenchmark(argc, argv);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
@@ -1,10 +1,14 @@
 //mainwindow.cpp
 #include "mainwindow.h"
 //#include "CanonicalLRParser.h"
+#include <climits>
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent)
+    : QMainWindow(parent),
+      tableCache((QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/tables").toStdString(),
+                 64ull << 20)
 {
+    parser.setTableCache(&tableCache);
     setupUI();
     createConnections();
 
@@ -30,7 +34,13 @@ void MainWindow::setupUI()
     grammarButtonLayout = new QHBoxLayout();
     loadGrammarButton = new QPushButton("Load Grammar", grammarGroup);
     generateButton = new QPushButton("Generate Parser", grammarGroup);
+    constructionModeCombo = new QComboBox(grammarGroup);
+    // Same order as ConstructionMode
+    constructionModeCombo->addItem("Canonical LR(1)");
+    constructionModeCombo->addItem("LALR(1)");
+    constructionModeCombo->addItem("Minimal LR(1)");
     grammarButtonLayout->addWidget(loadGrammarButton);
+    grammarButtonLayout->addWidget(constructionModeCombo);
     grammarButtonLayout->addWidget(generateButton);
     grammarInputEdit = new QPlainTextEdit(grammarGroup);
     grammarInputEdit->setPlainText("Enter your grammar here (e.g., E -> E + T | T\nT -> T * F | F\nF -> ( E ) | id)");
@@ -81,10 +91,16 @@ void MainWindow::setupUI()
     previousStepButton = new QPushButton("<< Previous", simulationOutputGroup);
     nextStepButton = new QPushButton("Next >>", simulationOutputGroup);
     resetButton = new QPushButton("Reset", simulationOutputGroup);
+    stepSpinBox = new QSpinBox(simulationOutputGroup);
+    stepSpinBox->setRange(0, INT_MAX);
+    stepSpinBox->setPrefix("Step ");
+    goToStepButton = new QPushButton("Go", simulationOutputGroup);
 
     simulationButtonLayout->addWidget(previousStepButton);
     simulationButtonLayout->addWidget(resetButton);
     simulationButtonLayout->addWidget(nextStepButton);
+    simulationButtonLayout->addWidget(stepSpinBox);
+    simulationButtonLayout->addWidget(goToStepButton);
 
     simulationOutputLayout->addLayout(simulationButtonLayout);
     /*****************************************/
@@ -118,6 +134,7 @@ void MainWindow::createConnections()
     connect(nextStepButton, &QPushButton::clicked, this, &MainWindow::onNextStepClicked);
     connect(previousStepButton, &QPushButton::clicked, this, &MainWindow::onPreviousStepClicked);
     connect(resetButton, &QPushButton::clicked, this, &MainWindow::onResetClicked);
+    connect(goToStepButton, &QPushButton::clicked, this, &MainWindow::onGoToStepClicked);
     /*******************************************/
 }
 
@@ -161,6 +178,7 @@ void MainWindow::onGenerateClicked()
         grammarFile.close();
     }
     try {
+        parser.setConstructionMode(static_cast<ConstructionMode>(constructionModeCombo->currentIndex()));
         parser.run();
 
         // Display grammar analysis in left panel
@@ -176,6 +194,12 @@ void MainWindow::onGenerateClicked()
     }
 }
 
+void MainWindow::onGoToStepClicked()
+{
+    parser.goToStep(static_cast<size_t>(stepSpinBox->value()));
+    updateSimulationDisplay();
+}
+
 /*void MainWindow::onSimulateClicked()
 {
     QString inputString = inputStringEdit->text();
@@ -207,6 +231,7 @@ void MainWindow::updateSimulationButtons()
 {
     nextStepButton->setEnabled(parser.hasNextStep());
     previousStepButton->setEnabled(parser.hasPreviousStep());
+    stepSpinBox->setValue(static_cast<int>(parser.getCurrentStep()));
 }
 
 void MainWindow::onNextStepClicked()
@@ -241,15 +266,8 @@ void MainWindow::onSimulateClicked()
         return;
     }
 
-    // Save input to temporary file
-    QFile inputFile("input.txt");
-    if (inputFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&inputFile);
-        out << inputString;
-        inputFile.close();
-    }
-
     try {
+        parser.setInput(inputString.toStdString());
         parser.simulateParser();
         /*simulationOutputDisplay->setPlainText(QString::fromStdString(parser.getCurrentStepOutput()));
         updateSimulationButtons();*/
@@ -1,17 +1,21 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 #include "CanonicalLRParser.h"
+#include "TableCache.h"
 
 #include <QMainWindow>
 #include <QPlainTextEdit>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QComboBox>
+#include <QSpinBox>
 #include <QGroupBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QTimer>  // Add this include
+#include <QStandardPaths>
 
 class MainWindow : public QMainWindow
 {
@@ -31,6 +35,7 @@ private slots:
     void onNextStepClicked();
     void onPreviousStepClicked();
     void onResetClicked();
+    void onGoToStepClicked();
     /************************************/
 
 private:
@@ -48,6 +53,7 @@ private:
     QPushButton *generateButton;
     QPushButton *loadInputButton;
     QPushButton *simulateButton;
+    QComboBox *constructionModeCombo;
 
     // Layouts
     QVBoxLayout *mainLayout;
@@ -67,12 +73,15 @@ private:
     QGroupBox *tableOutputGroup;    // New group for parse tables
     QGroupBox *simulationOutputGroup; // New group for parsing simulation
 
+    TableCache tableCache;  // generated tables reused across sessions
     CanonicalLRParser parser;
     /********************************/
     // Navigation buttons
     QPushButton *nextStepButton;
     QPushButton *previousStepButton;
     QPushButton *resetButton;
+    QSpinBox *stepSpinBox;
+    QPushButton *goToStepButton;
 
     /****************************/
 
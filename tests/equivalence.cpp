@@ -0,0 +1,623 @@
+// equivalence.cpp
+// Builds the tables of randomly generated grammars in every supported way
+// and checks that they agree:
+// - canonical LR(1) and LALR(1) against a textbook construction with one
+//   lookahead per item, state for state up to numbering;
+// - multi-threaded against sequential canonical LR(1) construction;
+// - the dense, compressed, reloaded (TableFile) and lazily built tables,
+//   and minimal LR(1) and LALR(1) where they are conflict-free, by their
+//   results on sentences of the grammar, near misses and random strings;
+// - incremental rebuilds after a few random edits (alternatives added,
+//   removed or changed) against fresh builds of the edited grammar, on the
+//   FIRST/FOLLOW sets and the automaton.
+// Before that, a few fixed grammars whose conflict resolution leaves
+// reductions that never read a token must be rejected by every table
+// instead of looping.
+//
+// Usage: equivalence [grammar count] [first seed]
+#include "CanonicalLRParser.h"
+#include "Grammar.h"
+#include "ParseTable.h"
+#include "ParseTables.h"
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const char* const grammarPath = "equivalence_grammar.txt";
+const char* const tablePath = "equivalence_tables.bin";
+
+int pick(std::mt19937& random, int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(random);
+}
+
+// A grammar kept small so that ε rules, recursion and conflicts are common
+struct RandomGrammar {
+    std::vector<std::string> nonTerminals;
+    std::vector<std::string> terminals;
+    std::vector<std::vector<std::string>> alternatives;   // by non-terminal, as GrammarInput reads them
+
+    std::string text() const;
+};
+
+std::string RandomGrammar::text() const {
+    std::ostringstream text;
+    for (size_t nonTerminal = 0; nonTerminal < nonTerminals.size(); ++nonTerminal) {
+        text << nonTerminals[nonTerminal] << " ->";
+        for (size_t i = 0; i < alternatives[nonTerminal].size(); ++i) {
+            text << (i > 0 ? " | " : " ") << alternatives[nonTerminal][i];
+        }
+        text << "\n";
+    }
+    return text.str();
+}
+
+std::string randomAlternative(std::mt19937& random, const RandomGrammar& grammar) {
+    if (pick(random, 0, 99) < 15) return SymbolTable::epsilon;
+    // Terminals twice as likely as non-terminals
+    const std::vector<std::string>& nonTerminals = grammar.nonTerminals;
+    const std::vector<std::string>& terminals = grammar.terminals;
+    int symbols = static_cast<int>(nonTerminals.size() + 2 * terminals.size());
+    std::string alternative;
+    for (int length = pick(random, 1, 4); length > 0; --length) {
+        int symbol = pick(random, 0, symbols - 1);
+        alternative += alternative.empty() ? "" : " ";
+        alternative += symbol < static_cast<int>(nonTerminals.size())
+                           ? nonTerminals[symbol]
+                           : terminals[(symbol - nonTerminals.size()) % terminals.size()];
+    }
+    return alternative;
+}
+
+RandomGrammar randomGrammar(std::mt19937& random) {
+    RandomGrammar grammar;
+    grammar.nonTerminals = {"S"};
+    for (int i = pick(random, 1, 6); i > 0; --i) {
+        grammar.nonTerminals.push_back("N" + std::to_string(i));
+    }
+    for (int i = pick(random, 1, 6); i > 0; --i) {
+        grammar.terminals.push_back("t" + std::to_string(i));
+    }
+    grammar.alternatives.resize(grammar.nonTerminals.size());
+    for (std::vector<std::string>& alternatives : grammar.alternatives) {
+        for (int count = pick(random, 1, 3); count > 0; --count) {
+            alternatives.push_back(randomAlternative(random, grammar));
+        }
+    }
+    return grammar;
+}
+
+// Adds, removes or changes one alternative; every non-terminal keeps at
+// least one
+void editGrammar(std::mt19937& random, RandomGrammar& grammar) {
+    std::vector<std::string>& alternatives =
+        grammar.alternatives[pick(random, 0, static_cast<int>(grammar.nonTerminals.size()) - 1)];
+    int alternative = pick(random, 0, static_cast<int>(alternatives.size()) - 1);
+    int kind = pick(random, 0, 2);
+    if (kind == 0) {
+        alternatives.push_back(randomAlternative(random, grammar));
+    } else if (kind == 1 && alternatives.size() > 1) {
+        alternatives.erase(alternatives.begin() + alternative);
+    } else {
+        alternatives[alternative] = randomAlternative(random, grammar);
+    }
+}
+
+SharedParseTables build(ConstructionMode mode, unsigned threads, bool compress, bool lazy) {
+    CanonicalLRParser parser;
+    parser.setGrammarFile(grammarPath);
+    parser.setConstructionMode(mode);
+    parser.setThreadCount(threads);
+    parser.setTableCompression(compress);
+    parser.setLazyConstruction(lazy);
+    parser.run();
+    parser.generateParseTable();
+    return parser.getTables();
+}
+
+// The canonical LR(1) collection as textbooks build it: an item is a
+// (rule, dot, lookahead) triple, closure() runs to a fixpoint over single
+// items and FIRST comes from its own fixpoint. Slow, but shares nothing with
+// ItemSetGenerator or FirstFollow.
+class Reference {
+public:
+    explicit Reference(const Grammar& grammar);
+
+    ParseTable canonical(size_t& conflicts) const { return table(states, transitions, conflicts); }
+    // Canonical states with the same core merged, lookaheads united
+    ParseTable lalr(size_t& conflicts) const;
+
+private:
+    typedef std::set<std::tuple<int, int, int>> State;
+    typedef std::map<std::pair<int, int>, int> Transitions;
+
+    const Grammar& grammar;
+    std::vector<std::set<int>> first;   // by symbol
+    std::vector<bool> nullable;         // by symbol
+    std::vector<State> states;
+    Transitions transitions;
+
+    State closure(State items) const;
+    ParseTable table(const std::vector<State>& states, const Transitions& transitions, size_t& conflicts) const;
+};
+
+Reference::Reference(const Grammar& grammar)
+    : grammar(grammar), first(grammar.symbols().size()), nullable(grammar.symbols().size(), false) {
+    const SymbolTable& symbols = grammar.symbols();
+    for (int terminal = 0; terminal < symbols.terminalCount(); ++terminal) {
+        first[terminal].insert(terminal);
+    }
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const Production& production : grammar.productions()) {
+            size_t before = first[production.lhs].size();
+            bool allNullable = true;
+            for (int symbol : production.rhs) {
+                first[production.lhs].insert(first[symbol].begin(), first[symbol].end());
+                if (!nullable[symbol]) {
+                    allNullable = false;
+                    break;
+                }
+            }
+            changed |= first[production.lhs].size() != before;
+            if (allNullable && !nullable[production.lhs]) {
+                nullable[production.lhs] = true;
+                changed = true;
+            }
+        }
+    }
+
+    int startRule = grammar.rulesOf(grammar.augmentedStart() - symbols.terminalCount()).first;
+    states.push_back(closure({std::make_tuple(startRule, 0, static_cast<int>(SymbolTable::endMarker))}));
+    std::map<State, int> index = {{states[0], 0}};
+    for (size_t state = 0; state < states.size(); ++state) {
+        for (int symbol = 0; symbol < symbols.size(); ++symbol) {
+            State kernel;
+            for (const auto& item : states[state]) {
+                const std::vector<int>& rhs = grammar.productions()[std::get<0>(item)].rhs;
+                if (std::get<1>(item) < static_cast<int>(rhs.size()) && rhs[std::get<1>(item)] == symbol) {
+                    kernel.insert(std::make_tuple(std::get<0>(item), std::get<1>(item) + 1, std::get<2>(item)));
+                }
+            }
+            if (kernel.empty()) continue;
+
+            State target = closure(kernel);
+            auto found = index.find(target);
+            if (found == index.end()) {
+                found = index.emplace(target, static_cast<int>(states.size())).first;
+                states.push_back(target);
+            }
+            transitions[{static_cast<int>(state), symbol}] = found->second;
+        }
+    }
+}
+
+Reference::State Reference::closure(State items) const {
+    std::vector<std::tuple<int, int, int>> pending(items.begin(), items.end());
+    while (!pending.empty()) {
+        int rule, dot, lookahead;
+        std::tie(rule, dot, lookahead) = pending.back();
+        pending.pop_back();
+        const std::vector<int>& rhs = grammar.productions()[rule].rhs;
+        if (dot >= static_cast<int>(rhs.size()) || grammar.symbols().isTerminal(rhs[dot])) continue;
+
+        // FIRST of what follows the non-terminal, then the item's lookahead
+        std::set<int> lookaheads;
+        bool restNullable = true;
+        for (size_t i = dot + 1; i < rhs.size() && restNullable; ++i) {
+            lookaheads.insert(first[rhs[i]].begin(), first[rhs[i]].end());
+            restNullable = nullable[rhs[i]];
+        }
+        if (restNullable) lookaheads.insert(lookahead);
+
+        for (int added : grammar.rulesOf(rhs[dot] - grammar.symbols().terminalCount())) {
+            for (int terminal : lookaheads) {
+                if (items.insert(std::make_tuple(added, 0, terminal)).second) {
+                    pending.push_back(std::make_tuple(added, 0, terminal));
+                }
+            }
+        }
+    }
+    return items;
+}
+
+ParseTable Reference::lalr(size_t& conflicts) const {
+    std::map<std::set<std::pair<int, int>>, int> coreIndex;
+    std::vector<int> merged(states.size());
+    std::vector<State> mergedStates;
+    for (size_t state = 0; state < states.size(); ++state) {
+        std::set<std::pair<int, int>> core;
+        for (const auto& item : states[state]) {
+            core.insert({std::get<0>(item), std::get<1>(item)});
+        }
+        auto found = coreIndex.emplace(core, static_cast<int>(mergedStates.size())).first;
+        if (found->second == static_cast<int>(mergedStates.size())) {
+            mergedStates.emplace_back();
+        }
+        merged[state] = found->second;
+        mergedStates[found->second].insert(states[state].begin(), states[state].end());
+    }
+
+    Transitions mergedTransitions;
+    for (const auto& transition : transitions) {
+        mergedTransitions[{merged[transition.first.first], transition.first.second}] = merged[transition.second];
+    }
+    return table(mergedStates, mergedTransitions, conflicts);
+}
+
+// As CanonicalLRParser::buildParseTable() fills it, item by item
+ParseTable Reference::table(const std::vector<State>& states, const Transitions& transitions,
+                            size_t& conflicts) const {
+    const SymbolTable& symbols = grammar.symbols();
+    const int terminalCount = symbols.terminalCount();
+    ParseTable table(static_cast<int>(states.size()), terminalCount, symbols.nonTerminalCount());
+    for (int rule = 0; rule < grammar.ruleCount(); ++rule) {
+        table.setRule(rule, grammar.productions()[rule].lhs - terminalCount, grammar.ruleLength(rule));
+    }
+
+    conflicts = 0;
+    for (size_t stateId = 0; stateId < states.size(); ++stateId) {
+        int state = static_cast<int>(stateId);
+        for (const auto& item : states[stateId]) {
+            int rule, dot, lookahead;
+            std::tie(rule, dot, lookahead) = item;
+            const Production& production = grammar.productions()[rule];
+            if (dot < static_cast<int>(production.rhs.size())) {
+                int symbol = production.rhs[dot];
+                int target = transitions.at({state, symbol});
+                if (symbols.isTerminal(symbol)) {
+                    conflicts += !table.setAction(state, symbol, ParseTable::makeAction(ParseTable::Shift, target));
+                } else {
+                    table.setGoto(state, symbol - terminalCount, target);
+                }
+            } else if (production.lhs == grammar.augmentedStart()) {
+                conflicts += !table.setAction(state, SymbolTable::endMarker,
+                                              ParseTable::makeAction(ParseTable::Accept, 0));
+            } else {
+                conflicts += !table.setAction(state, lookahead, ParseTable::makeAction(ParseTable::Reduce, rule));
+            }
+        }
+    }
+    return table;
+}
+
+// Whether two tables are the same automaton up to state numbering: walks
+// both from state 0, pairing the states their shifts and gotos reach
+bool sameAutomaton(const ParseTableView& a, const ParseTableView& b, std::string& difference) {
+    std::ostringstream why;
+    if (a.stateCount() != b.stateCount()) {
+        why << a.stateCount() << " states against " << b.stateCount();
+        difference = why.str();
+        return false;
+    }
+
+    std::vector<int> toB(a.stateCount(), -1);
+    std::vector<int> toA(b.stateCount(), -1);
+    std::deque<int> pending;
+    auto pair = [&](int stateA, int stateB) {
+        if (toB[stateA] < 0 && toA[stateB] < 0) {
+            toB[stateA] = stateB;
+            toA[stateB] = stateA;
+            pending.push_back(stateA);
+            return true;
+        }
+        return toB[stateA] == stateB;
+    };
+
+    pair(0, 0);
+    while (!pending.empty()) {
+        int stateA = pending.front();
+        int stateB = toB[stateA];
+        pending.pop_front();
+        for (int terminal = 0; terminal < a.terminalCount(); ++terminal) {
+            ParseTable::Action actionA = a.action(stateA, terminal);
+            ParseTable::Action actionB = b.action(stateB, terminal);
+            bool same = ParseTable::kind(actionA) == ParseTable::Shift && ParseTable::kind(actionB) == ParseTable::Shift
+                ? pair(ParseTable::value(actionA), ParseTable::value(actionB))
+                : actionA == actionB;
+            if (!same) {
+                why << "state " << stateA << "/" << stateB << ", terminal " << terminal << ": "
+                    << ParseTable::describe(actionA) << " against " << ParseTable::describe(actionB);
+                difference = why.str();
+                return false;
+            }
+        }
+        for (int nonTerminal = 0; nonTerminal < a.nonTerminalCount(); ++nonTerminal) {
+            int gotoA = a.gotoState(stateA, nonTerminal);
+            int gotoB = b.gotoState(stateB, nonTerminal);
+            if ((gotoA < 0) != (gotoB < 0) || (gotoA >= 0 && !pair(gotoA, gotoB))) {
+                why << "state " << stateA << "/" << stateB << ", non-terminal " << nonTerminal << ": goto "
+                    << gotoA << " against " << gotoB;
+                difference = why.str();
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Appends a random derivation of `symbol`; false once `steps` run out
+bool derive(const Grammar& grammar, int symbol, std::mt19937& random, int& steps, std::vector<int>& tokens) {
+    if (grammar.symbols().isTerminal(symbol)) {
+        tokens.push_back(symbol);
+        return true;
+    }
+    if (--steps < 0) return false;
+    Grammar::Rules rules = grammar.rulesOf(symbol - grammar.symbols().terminalCount());
+    if (rules.empty()) return false;
+    for (int rhsSymbol : grammar.productions()[pick(random, rules.first, rules.last - 1)].rhs) {
+        if (!derive(grammar, rhsSymbol, random, steps, tokens)) return false;
+    }
+    return true;
+}
+
+// Sentences derived from S, each with one token changed, dropped or added,
+// and random strings; terminal IDs without the end marker
+std::vector<std::vector<int>> sampleInputs(const Grammar& grammar, std::mt19937& random) {
+    const int terminals = grammar.symbols().terminalCount();
+    std::vector<std::vector<int>> inputs;
+    for (int attempt = 0; attempt < 20 && terminals > 1; ++attempt) {
+        std::vector<int> sentence;
+        int steps = 60;
+        if (!derive(grammar, grammar.symbols().id("S"), random, steps, sentence)) continue;
+        inputs.push_back(sentence);
+
+        int position = pick(random, 0, static_cast<int>(sentence.size()));
+        int token = pick(random, 1, terminals - 1);
+        switch (pick(random, 0, 2)) {
+        case 0:
+            if (position < static_cast<int>(sentence.size())) sentence[position] = token;
+            break;
+        case 1:
+            if (position < static_cast<int>(sentence.size())) sentence.erase(sentence.begin() + position);
+            break;
+        default:
+            sentence.insert(sentence.begin() + position, token);
+        }
+        inputs.push_back(sentence);
+    }
+    for (int count = 0; count < 20 && terminals > 1; ++count) {
+        std::vector<int> tokens(pick(random, 0, 8));
+        for (int& token : tokens) {
+            token = pick(random, 1, terminals - 1);
+        }
+        inputs.push_back(tokens);
+    }
+    return inputs;
+}
+
+bool checkGrammar(unsigned seed) {
+    std::mt19937 random(seed);
+    {
+        std::ofstream grammarFile(grammarPath);
+        grammarFile << randomGrammar(random).text();
+    }
+    auto fail = [seed](const std::string& what) {
+        std::cerr << "seed " << seed << ": " << what << "\n";
+        return false;
+    };
+
+    SharedParseTables canonical = build(ConstructionMode::CanonicalLR1, 1, false, false);
+    const Grammar& grammar = *canonical->grammar();
+    Reference reference(grammar);
+    std::string difference;
+
+    size_t conflicts = 0;
+    ParseTable expected = reference.canonical(conflicts);
+    if (!sameAutomaton(canonical->table(), expected.view(), difference)) {
+        return fail("canonical LR(1) differs from the reference: " + difference);
+    }
+    if ((conflicts == 0) != (canonical->conflictCount() == 0)) {
+        return fail("canonical LR(1) conflicts differ from the reference");
+    }
+
+    SharedParseTables parallel = build(ConstructionMode::CanonicalLR1, 4, false, false);
+    if (!sameAutomaton(canonical->table(), parallel->table(), difference)) {
+        return fail("multi-threaded canonical LR(1) differs: " + difference);
+    }
+
+    SharedParseTables lalr = build(ConstructionMode::LALR1, 1, false, false);
+    ParseTable expectedLalr = reference.lalr(conflicts);
+    if (!sameAutomaton(lalr->table(), expectedLalr.view(), difference)) {
+        return fail("LALR(1) differs from the reference: " + difference);
+    }
+    if ((conflicts == 0) != (lalr->conflictCount() == 0)) {
+        return fail("LALR(1) conflicts differ from the reference");
+    }
+
+    canonical->save(tablePath);
+    std::vector<std::pair<const char*, SharedParseTables>> variants = {
+        {"multi-threaded", parallel},
+        {"compressed", build(ConstructionMode::CanonicalLR1, 1, true, false)},
+        {"reloaded", ParseTables::load(tablePath)},
+        {"reloaded and compressed", ParseTables::load(tablePath, true)},
+        {"lazy", build(ConstructionMode::CanonicalLR1, 1, false, true)},
+    };
+    // Merging can only add conflicts, and resolving them changes the language
+    if (canonical->conflictCount() == 0) {
+        SharedParseTables minimal = build(ConstructionMode::MinimalLR1, 1, false, false);
+        if (minimal->conflictCount() != 0) {
+            return fail("minimal LR(1) has conflicts that canonical LR(1) has not");
+        }
+        variants.push_back({"minimal LR(1)", minimal});
+        if (lalr->conflictCount() == 0) {
+            variants.push_back({"LALR(1)", lalr});
+        }
+    }
+
+    std::vector<int> stack;
+    for (const std::vector<int>& tokens : sampleInputs(grammar, random)) {
+        ParseTable::Result want = canonical->parse(tokens, stack);
+        for (const auto& variant : variants) {
+            ParseTable::Result got = variant.second->parse(tokens, stack);
+            if (got.accepted != want.accepted || got.errorPosition != want.errorPosition) {
+                std::ostringstream input;
+                for (int token : tokens) {
+                    input << " " << grammar.symbols().name(token);
+                }
+                return fail(std::string(variant.first) + " tables disagree on" + input.str());
+            }
+        }
+    }
+    return true;
+}
+
+// The FIRST/FOLLOW section of CanonicalLRParser::run()'s output
+std::string firstFollowSection(const std::string& output) {
+    size_t begin = output.find("=== First and Follow Sets ===");
+    if (begin == std::string::npos) return "";
+    return output.substr(begin, output.find("=== Item Sets ===", begin) - begin);
+}
+
+// Edits a random grammar a few times, rebuilding incrementally after each
+// edit, and compares every rebuild with a fresh build of the edited grammar
+bool checkIncremental(unsigned seed) {
+    std::mt19937 random(seed);
+    RandomGrammar grammar = randomGrammar(random);
+    const ConstructionMode modes[] = {ConstructionMode::CanonicalLR1, ConstructionMode::LALR1,
+                                      ConstructionMode::MinimalLR1};
+    const ConstructionMode mode = modes[seed % 3];
+
+    CanonicalLRParser incremental;
+    incremental.setGrammarFile(grammarPath);
+    incremental.setConstructionMode(mode);
+    for (int edit = 0; edit <= 3; ++edit) {
+        if (edit > 0) editGrammar(random, grammar);
+        {
+            std::ofstream grammarFile(grammarPath);
+            grammarFile << grammar.text();
+        }
+        incremental.run();
+        incremental.generateParseTable();
+        if (edit == 0) continue;
+
+        CanonicalLRParser fresh;
+        fresh.setGrammarFile(grammarPath);
+        fresh.setConstructionMode(mode);
+        fresh.setIncremental(false);
+        fresh.run();
+        fresh.generateParseTable();
+
+        auto fail = [seed, edit, mode](const std::string& what) {
+            std::cerr << "seed " << seed << ", edit " << edit << ": incremental " << constructionModeName(mode)
+                      << " " << what << "\n";
+            return false;
+        };
+        std::string difference;
+        if (incremental.getOutput().find("Incremental build") == std::string::npos) {
+            return fail("rebuild was a full one");
+        }
+        if (firstFollowSection(incremental.getOutput()) != firstFollowSection(fresh.getOutput())) {
+            return fail("FIRST/FOLLOW sets differ from a fresh build");
+        }
+        if (!sameAutomaton(fresh.getTables()->table(), incremental.getTables()->table(), difference)) {
+            return fail("automaton differs from a fresh build: " + difference);
+        }
+    }
+    return true;
+}
+
+// Grammars and inputs on which the tables would reduce forever without
+// reading a token: a cyclic one, and one where ε rules around resolved
+// conflicts keep growing the stack
+struct LoopingGrammar {
+    const char* grammar;
+    std::vector<const char*> input;
+};
+
+bool checkLooping(const LoopingGrammar& looping) {
+    {
+        std::ofstream grammarFile(grammarPath);
+        grammarFile << looping.grammar;
+    }
+    auto fail = [&looping](const std::string& what) {
+        std::cerr << "looping grammar " << looping.grammar << what << "\n";
+        return false;
+    };
+
+    SharedParseTables canonical = build(ConstructionMode::CanonicalLR1, 1, false, false);
+    canonical->save(tablePath);
+    std::vector<std::pair<const char*, SharedParseTables>> variants = {
+        {"canonical LR(1)", canonical},
+        {"compressed", build(ConstructionMode::CanonicalLR1, 1, true, false)},
+        {"reloaded and compressed", ParseTables::load(tablePath, true)},
+        {"lazy", build(ConstructionMode::CanonicalLR1, 1, false, true)},
+        {"LALR(1)", build(ConstructionMode::LALR1, 1, false, false)},
+        {"compressed LALR(1)", build(ConstructionMode::LALR1, 1, true, false)},
+        {"minimal LR(1)", build(ConstructionMode::MinimalLR1, 1, false, false)},
+        {"compressed minimal LR(1)", build(ConstructionMode::MinimalLR1, 1, true, false)},
+    };
+
+    const SymbolTable& symbols = canonical->grammar()->symbols();
+    std::vector<int> tokens;
+    for (const char* name : looping.input) {
+        tokens.push_back(symbols.id(name));
+    }
+    std::vector<int> stack;
+    for (const auto& variant : variants) {
+        if (variant.second->parse(tokens, stack).accepted) {
+            return fail(std::string(variant.first) + " tables accept the input");
+        }
+    }
+    return true;
+}
+
+const LoopingGrammar loopingGrammars[] = {
+    {"S -> A\n"
+     "A -> A | a\n",
+     {"a"}},
+    {"S -> N3 t2 | N1 N1 N1\n"
+     "N3 -> ε | t3 N2 t2\n"
+     "N2 -> t3 t1 N3\n"
+     "N1 -> ε | N2 t3 t1 t2 | S N2 S t2\n",
+     {"t2"}},
+};
+
+}
+
+int main(int argc, char* argv[]) {
+    unsigned count = argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10)) : 1000;
+    unsigned firstSeed = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 1;
+
+    // GrammarInput announces every file it reads
+    std::ostringstream quiet;
+    std::streambuf* log = std::clog.rdbuf(quiet.rdbuf());
+
+    unsigned failures = 0;
+    for (const LoopingGrammar& looping : loopingGrammars) {
+        try {
+            failures += !checkLooping(looping);
+        } catch (const std::exception& e) {
+            std::cerr << "looping grammar " << looping.grammar << e.what() << "\n";
+            failures++;
+        }
+        quiet.str("");
+    }
+    for (unsigned seed = firstSeed; seed < firstSeed + count; ++seed) {
+        try {
+            failures += !(checkGrammar(seed) && checkIncremental(seed));
+        } catch (const std::exception& e) {
+            std::cerr << "seed " << seed << ": " << e.what() << "\n";
+            failures++;
+        }
+        quiet.str("");
+    }
+    std::clog.rdbuf(log);
+    std::remove(grammarPath);
+    std::remove(tablePath);
+
+    std::cout << count << " grammars, " << failures << " with differences\n";
+    return failures == 0 ? 0 : 1;
+}